@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""Compare two ulog_bench result files (JSON Lines from run.sh).
+
+usage: compare.py old.jsonl new.jsonl [--threshold PCT]
+
+Prints every metric present in both files with its relative change and
+exits with status 1 when any metric regressed by more than the threshold.
+For *_per_s metrics higher is better; for everything else lower is better.
+Timing changes smaller than 1 ns are ignored.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    results = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith('{'):
+                continue
+            r = json.loads(line)
+            results[(r['config'], r['metric'])] = r['value']
+    return results
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    ap.add_argument('old')
+    ap.add_argument('new')
+    ap.add_argument('--threshold', type=float, default=10.0,
+                    help='regression threshold in percent (default 10)')
+    args = ap.parse_args()
+
+    old, new = load(args.old), load(args.new)
+    regressed = 0
+    print('%-22s %-28s %12s %12s %8s' % ('config', 'metric', 'old', 'new', 'change'))
+    for key in sorted(old.keys() & new.keys()):
+        a, b = old[key], new[key]
+        if a == 0:
+            change = 0.0 if b == 0 else float('inf')
+        else:
+            change = (b - a) / abs(a) * 100.0
+        worse = -change if key[1].endswith('_per_s') else change
+        mark = ''
+        # 栈和字节数是确定值，任何增长都标出；耗时按阈值判断
+        if key[1].startswith(('stack_', 'bytes_')):
+            if worse > 0:
+                mark = '  <-- larger'
+                regressed += 1
+        elif worse > args.threshold and abs(b - a) >= 1.0:
+            mark = '  <-- slower'
+            regressed += 1
+        print('%-22s %-28s %12.2f %12.2f %+7.1f%%%s' % (key[0], key[1], a, b, change, mark))
+
+    for key in sorted(old.keys() - new.keys()):
+        print('%-22s %-28s missing in new results' % key)
+    sys.exit(1 if regressed else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,20 @@
+/* 主机测试用的 SEGGER RTT 替身：写入内存缓冲区并统计字节数 */
+#ifndef SEGGER_RTT_H
+#define SEGGER_RTT_H
+
+#define SUPPORT_SEGGER_RTT  1
+
+void     bench_rtt_lock(void);
+void     bench_rtt_unlock(void);
+
+/* 与 SEGGER_RTT_Conf.h 一致：LOCK 打开一个块，UNLOCK 关闭 */
+#define SEGGER_RTT_LOCK()   { bench_rtt_lock();
+#define SEGGER_RTT_UNLOCK() bench_rtt_unlock(); }
+
+void     SEGGER_RTT_Init(void);
+int      SEGGER_RTT_SetTerminal(unsigned char TerminalId);
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void *pBuffer, unsigned NumBytes);
+unsigned SEGGER_RTT_WriteNoLock(unsigned BufferIndex, const void *pBuffer, unsigned NumBytes);
+unsigned SEGGER_RTT_WriteString(unsigned BufferIndex, const char *s);
+
+#endif
@@ -0,0 +1,108 @@
+/* SEGGER RTT / EasyLogger / HAL_GetTick 的主机替身实现 */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "SEGGER_RTT.h"
+#include "elog.h"
+#include "main.h"
+
+#define BENCH_SINK_SIZE     (64 * 1024)
+
+/* 输出的总字节数，供测试统计 bytes/message */
+volatile unsigned long long bench_rtt_bytes;
+volatile unsigned long long bench_elog_bytes;
+
+static pthread_mutex_t rtt_lock = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static char     rtt_buf[BENCH_SINK_SIZE];
+static unsigned rtt_wr;
+
+void bench_rtt_lock(void)   { pthread_mutex_lock(&rtt_lock); }
+void bench_rtt_unlock(void) { pthread_mutex_unlock(&rtt_lock); }
+
+void SEGGER_RTT_Init(void)
+{
+}
+
+/* 和 RTT 一样逐字节拷入环形缓冲区 */
+unsigned SEGGER_RTT_WriteNoLock(unsigned BufferIndex, const void *pBuffer, unsigned NumBytes)
+{
+    const char *p = (const char *)pBuffer;
+
+    (void)BufferIndex;
+    for (unsigned i = 0; i < NumBytes; i++) {
+        rtt_buf[rtt_wr] = p[i];
+        rtt_wr = (rtt_wr + 1) & (BENCH_SINK_SIZE - 1);
+    }
+    bench_rtt_bytes += NumBytes;
+    return NumBytes;
+}
+
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void *pBuffer, unsigned NumBytes)
+{
+    bench_rtt_lock();
+    unsigned n = SEGGER_RTT_WriteNoLock(BufferIndex, pBuffer, NumBytes);
+    bench_rtt_unlock();
+    return n;
+}
+
+unsigned SEGGER_RTT_WriteString(unsigned BufferIndex, const char *s)
+{
+    return SEGGER_RTT_Write(BufferIndex, s, (unsigned)strlen(s));
+}
+
+int SEGGER_RTT_SetTerminal(unsigned char TerminalId)
+{
+    char ac[2] = { (char)0xFF, (char)('0' + TerminalId) };
+    SEGGER_RTT_Write(0, ac, 2);
+    return 0;
+}
+
+static pthread_mutex_t elog_lock = PTHREAD_MUTEX_INITIALIZER;
+static char elog_buf[1024];
+
+void elog_init(void)   {}
+void elog_start(void)  {}
+void elog_stop(void)   {}
+void elog_deinit(void) {}
+void elog_flush(void)  {}
+
+void elog_raw(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    pthread_mutex_lock(&elog_lock);
+    int n = vsnprintf(elog_buf, sizeof(elog_buf), format, args);
+    bench_elog_bytes += (n > 0) ? (unsigned)n : 0u;
+    pthread_mutex_unlock(&elog_lock);
+    va_end(args);
+}
+
+/* 近似 EasyLogger 默认格式："L/TAG   [时间] 正文" */
+void elog_output(unsigned char level, const char *tag, const char *format, ...)
+{
+    static const char lv[] = "AEWIDV";
+    va_list args;
+    va_start(args, format);
+    pthread_mutex_lock(&elog_lock);
+    int n = snprintf(elog_buf, sizeof(elog_buf), "%c/%-8s [%lu] ", lv[level % 6], tag,
+                     (unsigned long)HAL_GetTick());
+    if (n > 0 && (size_t)n < sizeof(elog_buf)) {
+        int m = vsnprintf(elog_buf + n, sizeof(elog_buf) - (size_t)n, format, args);
+        n += (m > 0) ? m : 0;
+    }
+    bench_elog_bytes += (n > 0) ? (unsigned)n : 0u;
+    pthread_mutex_unlock(&elog_lock);
+    va_end(args);
+}
+
+uint32_t HAL_GetTick(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000u + ts.tv_nsec / 1000000u);
+}
@@ -0,0 +1,20 @@
+/* 主机测试用的 EasyLogger 替身：按 EasyLogger 的方式格式化到内存并统计字节数 */
+#ifndef ELOG_H
+#define ELOG_H
+
+void elog_init(void);
+void elog_start(void);
+void elog_stop(void);
+void elog_deinit(void);
+void elog_flush(void);
+void elog_raw(const char *format, ...);
+void elog_output(unsigned char level, const char *tag, const char *format, ...);
+
+#define elog_assert(tag, ...)   elog_output(0, tag, __VA_ARGS__)
+#define elog_error(tag, ...)    elog_output(1, tag, __VA_ARGS__)
+#define elog_warn(tag, ...)     elog_output(2, tag, __VA_ARGS__)
+#define elog_info(tag, ...)     elog_output(3, tag, __VA_ARGS__)
+#define elog_debug(tag, ...)    elog_output(4, tag, __VA_ARGS__)
+#define elog_verbose(tag, ...)  elog_output(5, tag, __VA_ARGS__)
+
+#endif
@@ -0,0 +1,9 @@
+/* 主机测试用的 HAL 替身 */
+#ifndef MAIN_H
+#define MAIN_H
+
+#include <stdint.h>
+
+uint32_t HAL_GetTick(void);
+
+#endif
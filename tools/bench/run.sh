@@ -0,0 +1,71 @@
+#!/bin/sh
+# 在主机上按多种配置编译并运行 ulog_bench，结果（JSON Lines）输出到 stdout。
+#
+#   tools/bench/run.sh [条数] > results.jsonl
+#   tools/bench/compare.py old.jsonl results.jsonl
+#
+# 环境变量 CC / CXX / CFLAGS 可覆盖编译器和优化选项。
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+BENCH="$ROOT/tools/bench"
+COUNT=${1:-200000}
+CC=${CC:-cc}
+CXX=${CXX:-c++}
+CFLAGS=${CFLAGS:--O2}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+run() {
+    name=$1
+    shift
+    $CC $CFLAGS -I"$ROOT" -I"$BENCH/port" \
+        -DULOG_SHOW_LOG=0 -DULOG_LEVEL=ULOG_LEVEL_DEBUG "$@" \
+        "$ROOT/ulog.c" "$ROOT/ulog_crash.c" "$BENCH/port/bench_port.c" "$BENCH/ulog_bench.c" \
+        -o "$OUT/bench" -lpthread
+    "$OUT/bench" "$name" "$COUNT" "$OUT/stdout.log" 2>&1 >/dev/null
+}
+
+for backend in printf rtt elog; do
+    case $backend in
+        printf) method=ULOG_OUTPUT_PRINTF ;;
+        rtt)    method=ULOG_OUTPUT_RTT ;;
+        elog)   method=ULOG_OUTPUT_EASYLOGGER ;;
+    esac
+    for color in 0 1; do
+        for ts in 0 1; do
+            name=$backend
+            [ $color = 1 ] && name="$name,color"
+            [ $ts = 1 ] && name="$name,ts"
+            run "$name" -DULOG_OUTPUT_METHOD=$method \
+                -DULOG_COLOR_ENABLE=$color -DULOG_WITH_TIMESTAMP=$ts
+        done
+    done
+done
+
+# printf 输出的缓冲模式：整块 write(2) 代替逐条 fwrite
+run "printf,color,buffered" -DULOG_OUTPUT_METHOD=ULOG_OUTPUT_PRINTF -DULOG_COLOR_ENABLE=1 \
+    -DLOG_PRINTF_BUFFERED=1 -DLOG_PRINTF_BUFFER_SIZE=4096
+# 运行时级别控制打开时的额外开销与被屏蔽日志的耗时
+run "rtt,runtime" -DULOG_OUTPUT_METHOD=ULOG_OUTPUT_RTT -DLOG_RUNTIME_CONTROL
+# 线程安全的同步提交
+run "rtt,thread_safe" -DULOG_OUTPUT_METHOD=ULOG_OUTPUT_RTT -DLOG_ENABLE_THREAD_SAFE=1
+# 记录池代替栈缓冲区
+run "rtt,pool" -DULOG_OUTPUT_METHOD=ULOG_OUTPUT_RTT -DLOG_ENABLE_RECORD_POOL=1
+# 合并连续相同日志（每条日志多一次正文哈希）
+run "rtt,rate_limit" -DULOG_OUTPUT_METHOD=ULOG_OUTPUT_RTT -DLOG_ENABLE_RATE_LIMIT=1
+# 同时写入崩溃日志环形区
+run "rtt,crash" -DULOG_OUTPUT_METHOD=ULOG_OUTPUT_RTT -DLOG_ENABLE_CRASH_LOG=1
+# 仅用 HAL_GetTick 替身作为时钟源
+run "rtt,ts,tick" -DULOG_OUTPUT_METHOD=ULOG_OUTPUT_RTT -DULOG_WITH_TIMESTAMP=1 \
+    -DULOG_TS_SOURCE=ULOG_TS_SOURCE_TICK
+
+# C++ 前端（ulog.hpp）与 C 宏的对比，需要 C++20
+for src in ulog.c ulog_crash.c tools/bench/port/bench_port.c; do
+    $CC $CFLAGS -I"$ROOT" -I"$BENCH/port" -DULOG_SHOW_LOG=0 -DULOG_LEVEL=ULOG_LEVEL_DEBUG \
+        -DULOG_OUTPUT_METHOD=ULOG_OUTPUT_RTT -c "$ROOT/$src" -o "$OUT/$(basename "$src" .c).o"
+done
+$CXX -std=c++20 $CFLAGS -I"$ROOT" -I"$BENCH/port" -DULOG_SHOW_LOG=0 -DULOG_LEVEL=ULOG_LEVEL_DEBUG \
+    -DULOG_OUTPUT_METHOD=ULOG_OUTPUT_RTT "$BENCH/ulog_bench_cpp.cpp" \
+    "$OUT/ulog.o" "$OUT/ulog_crash.o" "$OUT/bench_port.o" -o "$OUT/bench_cpp" -lpthread
+"$OUT/bench_cpp" "rtt,cpp" "$COUNT" "$OUT/stdout.log" 2>&1 >/dev/null
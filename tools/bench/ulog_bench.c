@@ -0,0 +1,216 @@
+/*
+ * ULog 主机端性能基准
+ *
+ * 在 Linux 上用 port/ 下的替身（RTT、EasyLogger、HAL_GetTick）编译 ulog.c，
+ * 测量单条日志耗时、输出字节数、栈使用峰值和多线程吞吐量。
+ * 每项结果输出一行 JSON 到 stderr：
+ *   {"config":"rtt,color,ts","metric":"ns_per_msg","value":123.4}
+ * 配置组合由 run.sh 通过 -D 选项生成；compare.py 比较两次运行的结果。
+ */
+#include "ulog.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+extern volatile unsigned long long bench_rtt_bytes;
+extern volatile unsigned long long bench_elog_bytes;
+
+#define BENCH_STACK_SIZE    (64 * 1024)
+#define BENCH_STACK_FILL    0xA5
+#define BENCH_THREADS       4
+#define BENCH_REPEAT        5       /* 计时项重复次数，取最快一次以减小噪声 */
+
+static const char *bench_config = "default";
+static long        bench_count  = 200000;
+
+static double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void bench_report(const char *metric, double value)
+{
+    fprintf(stderr, "{\"config\":\"%s\",\"metric\":\"%s\",\"value\":%.2f}\n",
+            bench_config, metric, value);
+}
+
+/* 所有后端实际输出的字节数 */
+static unsigned long long bench_bytes(void)
+{
+    fflush(stdout);
+    long out = ftell(stdout);
+    return bench_rtt_bytes + bench_elog_bytes + (out > 0 ? (unsigned long long)out : 0u);
+}
+
+/* -------------------------------------------------------------------------- */
+/* 单线程耗时                                                                 */
+/* -------------------------------------------------------------------------- */
+static void bench_output(void)
+{
+    double best = 1e30;
+    unsigned long long b0 = bench_bytes();
+
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        double t0 = bench_now();
+        for (long i = 0; i < bench_count; i++) {
+            ULOG_I("sensor %ld value=%u name=%s\r\n", i, (unsigned)(i * 2654435761u), "temp0");
+        }
+        double dt = bench_now() - t0;
+        best = (dt < best) ? dt : best;
+    }
+    bench_report("ns_per_msg", best / bench_count);
+    bench_report("bytes_per_msg", (double)(bench_bytes() - b0) / bench_count / BENCH_REPEAT);
+}
+
+/* 编译期裁剪（ULOG_LEVEL = DEBUG 时 ULOG_V 为空）与运行时屏蔽的日志 */
+static void bench_disabled(void)
+{
+    volatile long sink = 0;
+    double t0 = bench_now();
+    for (long i = 0; i < bench_count; i++) {
+        ULOG_V("never %ld\r\n", i);
+        sink += i;
+    }
+    bench_report("ns_per_msg_disabled_static", (bench_now() - t0) / bench_count);
+    (void)sink;
+
+#if LOG_ENABLE_RUNTIME_LEVEL_CONTROL
+    ulog_set_level(ULOG_LEVEL_WARN);
+    t0 = bench_now();
+    for (long i = 0; i < bench_count; i++) {
+        ULOG_I("hidden %ld\r\n", i);
+    }
+    bench_report("ns_per_msg_disabled_runtime", (bench_now() - t0) / bench_count);
+    ulog_set_level(ULOG_LEVEL_VERBOSE);
+#endif
+}
+
+static void bench_hexdump(void)
+{
+    uint8_t data[256];
+    long n = bench_count / 100;
+    double best = 1e30;
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7);
+    }
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        double t0 = bench_now();
+        for (long i = 0; i < n; i++) {
+            ulog_hexdump("blk", 16, data, sizeof(data));
+        }
+        double dt = bench_now() - t0;
+        best = (dt < best) ? dt : best;
+    }
+    bench_report("ns_per_hexdump_256", best / n);
+}
+
+/* -------------------------------------------------------------------------- */
+/* 栈使用峰值：在预先填充的栈上运行一次，统计被改写的字节数                   */
+/* -------------------------------------------------------------------------- */
+static void *stack_nop(void *arg)
+{
+    return arg;
+}
+
+static void *stack_output(void *arg)
+{
+    ULOG_E("stack probe %d %s %08x %lld\r\n", 42, "abcdef", 0xBEEFu, -1LL);
+    return arg;
+}
+
+static void *stack_hexdump(void *arg)
+{
+    static const uint8_t data[64] = { 1, 2, 3 };
+    ulog_hexdump("stk", 16, data, sizeof(data));
+    return arg;
+}
+
+static size_t stack_used(void *(*fn)(void *))
+{
+    static uint8_t stack[BENCH_STACK_SIZE] __attribute__((aligned(64)));
+    pthread_attr_t attr;
+    pthread_t th;
+    size_t i;
+
+    memset(stack, BENCH_STACK_FILL, sizeof(stack));
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, sizeof(stack));
+    pthread_create(&th, &attr, fn, NULL);
+    pthread_join(th, NULL);
+    pthread_attr_destroy(&attr);
+
+    for (i = 0; i < sizeof(stack) && stack[i] == BENCH_STACK_FILL; i++) {
+    }
+    return sizeof(stack) - i;
+}
+
+static void bench_stack(void)
+{
+    size_t base = stack_used(stack_nop);
+    bench_report("stack_bytes_output", (double)(stack_used(stack_output) - base));
+    bench_report("stack_bytes_hexdump", (double)(stack_used(stack_hexdump) - base));
+}
+
+/* -------------------------------------------------------------------------- */
+/* 多线程吞吐量                                                               */
+/* -------------------------------------------------------------------------- */
+static void *mt_task(void *arg)
+{
+    long id = (long)arg;
+    for (long i = 0; i < bench_count / BENCH_THREADS; i++) {
+        ULOG_I("thread %ld msg %ld\r\n", id, i);
+    }
+    return NULL;
+}
+
+static void bench_threads(void)
+{
+    pthread_t th[BENCH_THREADS];
+    double best = 1e30;
+
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        double t0 = bench_now();
+        for (long i = 0; i < BENCH_THREADS; i++) {
+            pthread_create(&th[i], NULL, mt_task, (void *)i);
+        }
+        for (int i = 0; i < BENCH_THREADS; i++) {
+            pthread_join(th[i], NULL);
+        }
+        ulog_flush();
+        double dt = bench_now() - t0;
+        best = (dt < best) ? dt : best;
+    }
+    bench_report("mt_msgs_per_s", (double)(bench_count / BENCH_THREADS * BENCH_THREADS) / (best * 1e-9));
+}
+
+int main(int argc, char **argv)
+{
+    const char *sink = (argc > 3) ? argv[3] : "/tmp/ulog_bench_stdout.log";
+
+    if (argc > 1) {
+        bench_config = argv[1];
+    }
+    if (argc > 2) {
+        bench_count = atol(argv[2]);
+    }
+    /* printf 后端写入临时文件，按文件长度统计字节数 */
+    if (freopen(sink, "w", stdout) == NULL) {
+        perror(sink);
+        return 1;
+    }
+
+    ulog_init();
+    bench_output();
+    bench_disabled();
+    bench_hexdump();
+    bench_stack();
+    bench_threads();
+    ulog_deinit();
+
+    remove(sink);
+    return 0;
+}
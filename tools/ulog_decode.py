@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+"""ULog binary record decoder.
+
+Turns the stream produced by LOG_ENABLE_BINARY builds back into the same
+"[E/TAG] ..." lines the device would print in text mode.  Format strings
+are read from the `ulog_fmt` section of the firmware ELF, or from a raw
+dump of it (objcopy -O binary -j ulog_fmt fw.elf fmt.bin).
+
+Structured records (LOG_ENABLE_KV with LOG_KV_FORMAT = ULOG_KV_TLV) in the
+same stream are printed as "[E/TAG] {json}" lines and need no ELF.
+
+usage: ulog_decode.py [--elf fw.elf | --table fmt.bin] [--ts-format N]
+                      [--color] [--terminal N] [stream]   (default: stdin)
+"""
+
+import argparse
+import json
+import math
+import re
+import struct
+import sys
+
+SYNC_MASK = 0xF0
+SYNC = 0xA0
+KV_SYNC = 0xB0
+F_TS = 0x01
+F_TRUNC = 0x02
+
+KV_BOOL, KV_INT, KV_UINT, KV_FLOAT, KV_STR, KV_BYTES = range(6)
+
+COLORS = {
+    'A': '\x1b[2;35m', 'E': '\x1b[2;31m', 'W': '\x1b[2;33m',
+    'I': '\x1b[2;36m', 'D': '\x1b[2;32m', 'V': '\x1b[2;37m',
+}
+RESET = '\x1b[0m'
+
+CONV_RE = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|j|z|t|L)?([diuxXocpfFeEgGaAsn%])')
+
+
+def load_elf_section(path, name='ulog_fmt'):
+    with open(path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF':
+        raise SystemExit('%s: not an ELF file' % path)
+    is64 = elf[4] == 2
+    end = '<' if elf[5] == 1 else '>'
+    if is64:
+        shoff, = struct.unpack_from(end + 'Q', elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + 'HHH', elf, 0x3A)
+        sh_fmt = end + 'IIQQQQIIQQ'
+    else:
+        shoff, = struct.unpack_from(end + 'I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + 'HHH', elf, 0x2E)
+        sh_fmt = end + 'IIIIIIIIII'
+    sections = [struct.unpack_from(sh_fmt, elf, shoff + i * shentsize) for i in range(shnum)]
+    strtab = sections[shstrndx]
+    str_off = strtab[4]
+    for sh in sections:
+        name_off = str_off + sh[0]
+        sec_name = elf[name_off:elf.index(b'\0', name_off)].decode()
+        if sec_name == name:
+            return elf[sh[4]:sh[4] + sh[5]]
+    raise SystemExit('%s: no %s section (was LOG_ENABLE_BINARY set?)' % (path, name))
+
+
+def read_varint(buf, pos):
+    value = shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return value, pos
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def format_message(fmt, payload, pos, truncated):
+    """Re-apply the C format string using the encoded arguments."""
+    out = []
+    last = 0
+    for m in CONV_RE.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, lm, conv = m.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        try:
+            if width == '*':
+                v, pos = read_varint(payload, pos)
+                width = str(unzigzag(v))
+            if prec == '*':
+                v, pos = read_varint(payload, pos)
+                prec = str(unzigzag(v))
+            spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+            if conv in 'di':
+                v, pos = read_varint(payload, pos)
+                out.append((spec + 'd') % unzigzag(v))
+            elif conv in 'uxXo':
+                v, pos = read_varint(payload, pos)
+                out.append((spec + ('d' if conv == 'u' else conv)) % v)
+            elif conv == 'c':
+                v, pos = read_varint(payload, pos)
+                # %lc carries the whole wide character
+                out.append((spec + 'c') % chr(v if lm == 'l' else v & 0xFF))
+            elif conv == 'p':
+                v, pos = read_varint(payload, pos)
+                out.append('0x%x' % v)
+            elif conv in 'fFeEgGaA':
+                if pos + 8 > len(payload):
+                    raise IndexError
+                v, = struct.unpack_from('<d', payload, pos)
+                pos += 8
+                out.append(v.hex() if conv in 'aA' else (spec + conv) % v)
+            elif conv == 's':
+                n, pos = read_varint(payload, pos)
+                if pos + n > len(payload):
+                    raise IndexError
+                out.append((spec + 's') % payload[pos:pos + n].decode('utf-8', 'replace'))
+                pos += n
+                if truncated and pos >= len(payload):
+                    # A string cut to fit the record; nothing was encoded after it.
+                    raise IndexError
+        except IndexError:
+            # Arguments that did not fit into LOG_BINARY_RECORD_SIZE; keep the
+            # line ending so the following record starts on its own line.
+            out.append('...' if truncated else '<?>')
+            out.append(fmt[len(fmt.rstrip('\r\n')):])
+            return ''.join(out), pos
+    out.append(fmt[last:])
+    return ''.join(out), pos
+
+
+def format_timestamp(tick, style):
+    if style == 0:
+        return '[%u ms]' % tick
+    days = tick // 86400000
+    return '[%02ud-%02uh:%02um:%02us^%03ums]' % (
+        days, tick // 3600000 % 24, tick // 60000 % 60, tick // 1000 % 60, tick % 1000)
+
+
+def decode_kv(rec, flags):
+    """Structured record -> (terminal, level, tag, tick or None, object)."""
+    terminal, level, tag_len = rec[0], chr(rec[1]), rec[2]
+    tag = rec[3:3 + tag_len].decode('utf-8', 'replace')
+    p = 3 + tag_len
+    tick = None
+    if flags & F_TS:
+        tick, = struct.unpack_from('<I', rec, p)
+        p += 4
+    n, p = read_varint(rec, p)
+    obj = {'msg': rec[p:p + n].decode('utf-8', 'replace')}
+    p += n
+    while p < len(rec):
+        kind, klen = rec[p], rec[p + 1]
+        key = rec[p + 2:p + 2 + klen].decode('utf-8', 'replace')
+        p += 2 + klen
+        if kind == KV_BOOL:
+            value = bool(rec[p])
+            p += 1
+        elif kind == KV_INT:
+            v, p = read_varint(rec, p)
+            value = unzigzag(v)
+        elif kind == KV_UINT:
+            value, p = read_varint(rec, p)
+        elif kind == KV_FLOAT:
+            value, = struct.unpack_from('<d', rec, p)
+            value = value if math.isfinite(value) else None     # as the JSON encoder does
+            p += 8
+        elif kind in (KV_STR, KV_BYTES):
+            n, p = read_varint(rec, p)
+            raw = rec[p:p + n]
+            p += n
+            value = raw.decode('utf-8', 'replace') if kind == KV_STR else raw.hex()
+        else:
+            raise ValueError('unknown value type %d' % kind)
+        obj[key] = value
+    if flags & F_TRUNC:
+        obj['trunc'] = True
+    return terminal, level, tag, tick, obj
+
+
+def decode(stream, table, ts_format, color, terminal_filter, write):
+    pos = 0
+    while pos + 2 <= len(stream):
+        head = stream[pos]
+        if head & SYNC_MASK == KV_SYNC and pos + 3 <= len(stream):
+            length = stream[pos + 1] | stream[pos + 2] << 8
+            if pos + 3 + length <= len(stream):
+                try:
+                    terminal, level, tag, tick, obj = decode_kv(stream[pos + 3:pos + 3 + length], head)
+                except (IndexError, ValueError, struct.error):
+                    pos += 1
+                    continue
+                pos += 3 + length
+                if terminal_filter is not None and terminal != terminal_filter:
+                    continue
+                line = '[%s/%s] ' % (level, tag) if tag else ''
+                if tick is not None:
+                    line += format_timestamp(tick, ts_format) + ' '
+                line += json.dumps(obj, ensure_ascii=False, separators=(',', ':')) + '\n'
+                if color:
+                    line = COLORS.get(level, '') + line + RESET
+                write(line)
+                continue
+        length = stream[pos + 1]
+        if head & SYNC_MASK != SYNC or pos + 2 + length > len(stream) or table is None:
+            pos += 1        # resynchronise on the next sync byte
+            continue
+        rec = stream[pos + 2:pos + 2 + length]
+        pos += 2 + length
+        try:
+            terminal = rec[0]
+            entry_id, p = read_varint(rec, 1)
+            nul = table.index(b'\0', entry_id)
+            fmt_end = table.index(b'\0', nul + 1)
+        except (IndexError, ValueError):
+            continue
+        level = chr(table[entry_id])
+        tag = table[entry_id + 1:nul].decode()
+        fmt = table[nul + 1:fmt_end].decode('utf-8', 'replace')
+
+        line = '[%s/%s] ' % (level, tag) if tag else ''
+        if head & F_TS:
+            tick, = struct.unpack_from('<I', rec, p)
+            p += 4
+            line += format_timestamp(tick, ts_format) + ' '
+        body, _ = format_message(fmt, rec, p, head & F_TRUNC)
+        line += body
+        if terminal_filter is not None and terminal != terminal_filter:
+            continue
+        if color:
+            line = COLORS.get(level, '') + line + RESET
+        write(line)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    src = ap.add_mutually_exclusive_group()
+    src.add_argument('--elf', help='firmware ELF containing the ulog_fmt section')
+    src.add_argument('--table', help='raw dump of the ulog_fmt section')
+    ap.add_argument('--ts-format', type=int, default=1, choices=(0, 1, 2),
+                    help='ULOG_TIMESTAMP_FORMAT used by the firmware '
+                         '(records carry milliseconds, so 2 prints like 1)')
+    ap.add_argument('--color', action='store_true', help='colorize by level')
+    ap.add_argument('--terminal', type=int, help='only show records for this RTT terminal')
+    ap.add_argument('stream', nargs='?', help='captured record stream (default: stdin)')
+    args = ap.parse_args()
+
+    table = None
+    if args.elf:
+        table = load_elf_section(args.elf)
+    elif args.table:
+        with open(args.table, 'rb') as f:
+            table = f.read()
+    if args.stream:
+        with open(args.stream, 'rb') as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    decode(data, table, args.ts_format, args.color, args.terminal, sys.stdout.write)
+
+
+if __name__ == '__main__':
+    main()
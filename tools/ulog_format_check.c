@@ -0,0 +1,110 @@
+/*
+ * 格式化引擎与 C 库的对比（主机）：同一格式串和参数分别交给 ulog_output_ex 和 snprintf，
+ * 用一个只截取正文段的后端比较两者的结果。覆盖整数、字符串、%c %p %% 的标志/宽度/精度，
+ * 以及浮点、宽字符 %ls %lc 和 * 宽度/精度之后还有其他参数的情况。
+ *
+ *   gcc -O2 -I. -DULOG_SHOW_LOG=0 ulog.c tools/ulog_format_check.c -o ulog_format_check
+ *   ./ulog_format_check
+ */
+#include "ulog.h"
+
+#include <locale.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <wchar.h>
+
+static char capture[ULOG_BUFFER_SIZE + 1];
+static int  fails;
+static int  checks;
+
+static void capture_write(ulog_backend_t *be, unsigned char terminal, char level,
+                          const char *tag, const ulog_seg_t seg[ULOG_SEG_COUNT])
+{
+    (void)be;
+    (void)terminal;
+    (void)level;
+    (void)tag;
+    size_t n = seg[2].len < sizeof(capture) - 1 ? seg[2].len : sizeof(capture) - 1;
+    memcpy(capture, seg[2].ptr, n);
+    capture[n] = '\0';
+}
+
+static ulog_backend_t capture_backend = {
+    .name  = "check",
+    .level = ULOG_LEVEL_VERBOSE,
+    .write = capture_write,
+};
+
+static void compare(const char *fmt, const char *expect)
+{
+    checks++;
+    if (strcmp(capture, expect) != 0) {
+        fails++;
+        fprintf(stderr, "FAIL fmt=[%s]\n  ulog=[%s]\n  libc=[%s]\n", fmt, capture, expect);
+    }
+}
+
+/* 以 RAW 方式输出，正文段即格式化结果 */
+#define CHECK(fmt, ...) do {                                                        \
+        char expect_[ULOG_BUFFER_SIZE + 1];                                         \
+        snprintf(expect_, sizeof(expect_), fmt, __VA_ARGS__);                       \
+        capture[0] = '\0';                                                          \
+        ulog_output_ex(0, 0, "", fmt, __VA_ARGS__);                                 \
+        compare(fmt, expect_);                                                      \
+    } while (0)
+
+int main(void)
+{
+    static const int ivals[] = { 0, 1, -1, 42, -42, 2147483647, -2147483647 - 1, 123456 };
+    static const long long llvals[] = { 0, -1, 9223372036854775807LL, -9223372036854775807LL - 1,
+                                        5000000000LL };
+    static const double dvals[] = { 0.0, -0.0, 3.14159, -2.5, 1e-7, 6.02e23, 1e30 };
+
+    setlocale(LC_ALL, "C.UTF-8");
+    ulog_init();
+    ulog_backend_unregister(ulog_backend_find("printf"));
+    ulog_backend_register(&capture_backend);
+
+    for (size_t i = 0; i < sizeof(ivals) / sizeof(ivals[0]); i++) {
+        int v = ivals[i];
+        CHECK("%d|%5d|%-5d|%05d|%+d|% d", v, v, v, v, v, v);
+        CHECK("%.3d|%8.3d|%-8.3d|%.0d|%i", v, v, v, v, v);
+        CHECK("%x|%X|%#x|%#X|%08x|%#010x", v, v, v, v, v, v);
+        CHECK("%o|%#o|%u|%hd|%hhd|%hu|%hhx", v, v, v, v, v, v, v);
+        CHECK("%*d|%-*d|%.*d|%*.*d|end=%d", 7, v, 7, v, 4, v, -6, 3, v, 99);
+    }
+    for (size_t i = 0; i < sizeof(llvals) / sizeof(llvals[0]); i++) {
+        long long v = llvals[i];
+        CHECK("%lld|%llx|%llu|%20lld|", v, v, (unsigned long long)v, v);
+        CHECK("%ld|%lu|%jd", (long)v, (unsigned long)v, (intmax_t)v);
+    }
+    CHECK("%zu %zd", (size_t)12345, (ptrdiff_t)-3);
+    CHECK("%s|%10s|%-10s|%.2s|%5.1s|%*s|%.*s|", "abc", "abc", "abc", "abc", "abc", 6, "abc", 1, "abc");
+    CHECK("%c|%3c|%-3c|", 'x', 'y', 'z');
+    CHECK("%p", (void *)0x1234abcd);
+    CHECK("100%% done %d%%", 5);
+
+    /* 浮点交给 C 库，宽度/精度的 * 参数只能读一次，后面的参数位置不能错 */
+    for (size_t i = 0; i < sizeof(dvals) / sizeof(dvals[0]); i++) {
+        double d = dvals[i];
+        CHECK("%f|%.2f|%10.3f|%-10.1f|%+e|%G|%a|%#.0f", d, d, d, d, d, d, d, d);
+        CHECK("a=%.*f b=%d", 2, d, 42);
+        CHECK("a=%*f| b=%d", 14, d, 42);
+        CHECK("a=%*.*e b=%d c=%s", -12, 3, d, 42, "tail");
+        CHECK("a=%0*.*f b=%.*f c=%x", 12, 1, d, -1, d, 0xbeefu);
+        CHECK("a=%Lf b=%d", (long double)d, 7);
+    }
+    CHECK("mix %d %s %f %d", 1, "two", 3.5, 4);
+    CHECK("%.2f then %s %d", 2.345, "s", 9);
+    CHECK("%*s|%5.1f|%*d", -4, "x", 2.25, 3, 5);
+
+    /* 宽字符按 locale 转换，参数是 wchar_t * / wint_t，不能当成窄字符串读取 */
+    CHECK("%ls|%8ls|%-8ls|%.2ls|%d", L"abc", L"abc", L"\u00e9t\u00e9", L"abc", 7);
+    CHECK("%lc|%3lc|%-3lc|%s", (wint_t)L'x', (wint_t)L'\u00e9', (wint_t)L'z', "end");
+    CHECK("%*ls|%.*ls|%c", 6, L"wide", 1, L"wide", 'k');
+
+    ulog_backend_unregister(&capture_backend);
+    ulog_deinit();
+    printf("%d checks, %d failed\n", checks, fails);
+    return fails ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+/*
+ * 共享内存后端吞吐量测试：同一批日志分别走 printf 后端（stdout 重定向到文件）
+ * 和共享内存后端，输出 条/秒 与 每条耗时。可同时运行 ulog_shm_view 观察丢失情况：
+ * 查看器跟不上时写入方不受影响，查看器报告丢失的条数。
+ *
+ *   gcc -O2 -I. -DLOG_ENABLE_SHM=1 ulog.c ulog_shm.c tools/ulog_shm_bench.c -o ulog_shm_bench -lpthread
+ *   ./ulog_shm_bench [条数] [printf 输出文件]
+ */
+#include "ulog.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#if !LOG_ENABLE_SHM
+#error "build with -DLOG_ENABLE_SHM=1"
+#endif
+
+static double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void bench_run(const char *name, long count)
+{
+    double t0 = bench_now();
+    for (long i = 0; i < count; i++) {
+        ULOG_I_TAG("BENCH", "sensor %ld value=%d status=0x%08x\r\n", i, (int)(i * 7), (unsigned)i ^ 0xDEADBEEFu);
+    }
+    ulog_flush();
+    double dt = bench_now() - t0;
+
+    fprintf(stderr, "%-7s %10.0f msg/s  %6.0f ns/msg  (%ld msgs, %.3f s)\n",
+            name, count / dt, dt * 1e9 / count, count, dt);
+}
+
+int main(int argc, char **argv)
+{
+    long count = (argc > 1) ? atol(argv[1]) : 1000000;
+    const char *out = (argc > 2) ? argv[2] : "/tmp/ulog_printf_bench.log";
+    ulog_backend_t *pf = ulog_backend_find("printf");
+
+    if (freopen(out, "w", stdout) == NULL) {
+        perror(out);
+        return 1;
+    }
+    ulog_init();
+
+    if (pf != NULL) {
+        ulog_backend_shm.level = ULOG_LEVEL_ASSERT;
+        bench_run("printf", count);
+        pf->level = ULOG_LEVEL_ASSERT;
+    }
+    ulog_backend_shm.level = ULOG_LEVEL_VERBOSE;
+    bench_run("shm", count);
+
+    ulog_deinit();
+    return 0;
+}
@@ -0,0 +1,278 @@
+/*
+ * 共享内存日志查看器（Linux）：附加到 LOG_ENABLE_SHM 进程的环形缓冲区，跟随输出、
+ * 按级别着色并过滤。查看器只读共享内存，处理得慢时写入方照常覆盖最旧的记录，
+ * 查看器从最旧的完整记录继续，并按序号报告丢失的条数。写入方重启后自动重新附加。
+ *
+ *   gcc -O2 -I. tools/ulog_shm_view.c -o ulog_shm_view
+ *   ./ulog_shm_view [-n 名称] [-l 级别] [-t 标签,...] [-T 终端] [-g 文本] [-N] [-d] [-C]
+ *     -n  shm_open 名称，默认 LOG_SHM_NAME（"/ulog"）
+ *     -l  只显示这些级别，例如 EW；R 为无级别的 RAW 输出
+ *     -t  只显示这些标签
+ *     -T  只显示该 RTT 终端号
+ *     -g  只显示包含该文本的记录
+ *     -N  只显示附加之后的新记录（默认从缓冲区中最旧的记录开始）
+ *     -d  输出缓冲区中已有的记录后退出
+ *     -C  不着色（输出不是终端时默认不着色）
+ */
+#define _GNU_SOURCE             /* memmem */
+#include "ulog.h"
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef LOG_SHM_NAME
+#define LOG_SHM_NAME    "/ulog"
+#endif
+
+#define VIEW_ALIGN(n)   (((n) + 7u) & ~(uint64_t)7u)
+#define VIEW_AT(field)  ((_Atomic uint64_t *)&view.hdr->field)
+
+static struct {
+    const char        *name;
+    const char        *levels;
+    const char        *tags;
+    const char        *grep;
+    int                terminal;
+    bool               color;
+    bool               only_new;
+    bool               dump;
+
+    ulog_shm_header_t *hdr;
+    const char        *data;
+    char              *payload;         /* 一条记录最多为数据区的 1/4 */
+    size_t             map_len;
+    uint64_t           mask;
+    uint32_t           pid;
+} view = {
+    .name     = LOG_SHM_NAME,
+    .terminal = -1,
+};
+
+static const char *view_color(char level)
+{
+    switch (level) {
+        case 'A': return "\x1b[2;35m";
+        case 'E': return "\x1b[2;31m";
+        case 'W': return "\x1b[2;33m";
+        case 'I': return "\x1b[2;36m";
+        case 'D': return "\x1b[2;32m";
+        case 'V': return "\x1b[2;37m";
+        default : return "";
+    }
+}
+
+static void view_sleep_ms(long ms)
+{
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static void view_detach(void)
+{
+    if (view.hdr != NULL) {
+        munmap(view.hdr, view.map_len);
+        view.hdr = NULL;
+    }
+    free(view.payload);
+    view.payload = NULL;
+}
+
+/* 映射共享内存；尚未创建或尚未初始化时返回 false */
+static bool view_attach(void)
+{
+    struct stat st;
+    int fd = shm_open(view.name, O_RDONLY, 0);
+
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ulog_shm_header_t)) {
+        close(fd);
+        return false;
+    }
+    view.map_len = (size_t)st.st_size;
+    view.hdr = mmap(NULL, view.map_len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view.hdr == MAP_FAILED) {
+        view.hdr = NULL;
+        return false;
+    }
+
+    uint32_t magic = atomic_load_explicit((_Atomic uint32_t *)&view.hdr->magic, memory_order_acquire);
+    uint32_t size  = view.hdr->size;
+    if (magic != ULOG_SHM_MAGIC || view.hdr->version != ULOG_SHM_VERSION ||
+        (size & (size - 1)) || sizeof(ulog_shm_header_t) + size > view.map_len) {
+        view_detach();
+        return false;
+    }
+    view.payload = malloc(size / 4);
+    if (view.payload == NULL) {
+        view_detach();
+        return false;
+    }
+    view.data = (const char *)(view.hdr + 1);
+    view.mask = size - 1u;
+    view.pid  = view.hdr->pid;
+    return true;
+}
+
+static void view_copy(uint64_t pos, void *dst, size_t n)
+{
+    size_t size  = (size_t)view.mask + 1;
+    size_t off   = (size_t)(pos & view.mask);
+    size_t first = (n < size - off) ? n : size - off;
+
+    memcpy(dst, view.data + off, first);
+    memcpy((char *)dst + first, view.data, n - first);
+}
+
+static bool view_tag_match(const char *tag, size_t len)
+{
+    const char *p = view.tags;
+
+    while (*p) {
+        size_t n = strcspn(p, ",");
+        if (n == len && memcmp(p, tag, n) == 0) {
+            return true;
+        }
+        p += n + (p[n] == ',');
+    }
+    return false;
+}
+
+static void view_print(const ulog_shm_record_t *rec, const char *payload)
+{
+    const char *tag  = payload;
+    const char *text = payload + rec->tag_len;
+    size_t len = rec->size - sizeof(*rec) - rec->tag_len;
+    char lv = rec->level ? rec->level : 'R';
+
+    if (view.levels != NULL && strchr(view.levels, lv) == NULL) {
+        return;
+    }
+    if (view.tags != NULL && !view_tag_match(tag, rec->tag_len)) {
+        return;
+    }
+    if (view.terminal >= 0 && rec->terminal != view.terminal) {
+        return;
+    }
+    if (view.grep != NULL && memmem(text, len, view.grep, strlen(view.grep)) == NULL) {
+        return;
+    }
+
+    bool colored = view.color && rec->level;
+    if (colored) {
+        fputs(view_color(rec->level), stdout);
+    }
+    fwrite(text, 1, len, stdout);
+    if (colored) {
+        fputs("\x1b[0m", stdout);
+    }
+    if (len == 0 || text[len - 1] != '\n') {
+        fputs("\r\n", stdout);
+    }
+}
+
+static void view_note(const char *fmt, unsigned long v)
+{
+    if (view.color) {
+        fputs("\x1b[1;31m", stdout);
+    }
+    printf(fmt, v);
+    if (view.color) {
+        fputs("\x1b[0m", stdout);
+    }
+    fputs("\r\n", stdout);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t rd = 0;
+    uint32_t expect = 0;
+    bool synced = false;    /* expect 有效 */
+    int opt;
+
+    view.color = isatty(STDOUT_FILENO);
+    while ((opt = getopt(argc, argv, "n:l:t:T:g:NdC")) != -1) {
+        switch (opt) {
+            case 'n': view.name = optarg; break;
+            case 'l': view.levels = optarg; break;
+            case 't': view.tags = optarg; break;
+            case 'T': view.terminal = atoi(optarg); break;
+            case 'g': view.grep = optarg; break;
+            case 'N': view.only_new = true; break;
+            case 'd': view.dump = true; break;
+            case 'C': view.color = false; break;
+            default:
+                fprintf(stderr, "usage: %s [-n name] [-l levels] [-t tags] [-T terminal] [-g text] [-N] [-d] [-C]\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+
+    for (;;) {
+        /* 附加；写入方重启（pid 变化或 magic 失效）时重新映射 */
+        if (view.hdr == NULL ||
+            atomic_load_explicit((_Atomic uint32_t *)&view.hdr->magic, memory_order_acquire) != ULOG_SHM_MAGIC ||
+            view.hdr->pid != view.pid) {
+            bool restarted = (view.hdr != NULL);
+            view_detach();
+            if (!view_attach()) {
+                if (view.dump) {
+                    fprintf(stderr, "%s: no ulog shared memory\n", view.name);
+                    return 1;
+                }
+                view_sleep_ms(200);
+                continue;
+            }
+            rd = atomic_load_explicit(view.only_new ? VIEW_AT(head) : VIEW_AT(tail), memory_order_acquire);
+            /* 看到了写入方重启时，从第 0 条起计算丢失 */
+            expect = 0;
+            synced = restarted && !view.only_new;
+            view_note("---- attached, writer pid %lu ----", (unsigned long)view.pid);
+        }
+
+        uint64_t head = atomic_load_explicit(VIEW_AT(head), memory_order_acquire);
+        if (rd == head) {
+            if (view.dump) {
+                break;
+            }
+            fflush(stdout);
+            view_sleep_ms(10);
+            continue;
+        }
+
+        ulog_shm_record_t rec;
+        bool ok = (head - rd <= view.mask + 1);
+        if (ok) {
+            view_copy(rd, &rec, sizeof(rec));
+            ok = rec.size >= sizeof(rec) + rec.tag_len && rec.size <= (view.mask + 1) / 4;
+            if (ok) {
+                view_copy(rd + sizeof(rec), view.payload, rec.size - sizeof(rec));
+            }
+            /* 拷贝完成后再看 reserve：拷贝期间被覆盖的数据不能使用 */
+            atomic_thread_fence(memory_order_acquire);
+            ok = ok && atomic_load_explicit(VIEW_AT(reserve), memory_order_relaxed) - rd <= view.mask + 1;
+        }
+        if (!ok) {
+            /* 落后超过一圈：从最旧的完整记录继续，丢失条数由下一条的序号得出 */
+            rd = atomic_load_explicit(VIEW_AT(tail), memory_order_acquire);
+            continue;
+        }
+
+        if (synced && rec.seq != expect) {
+            view_note("---- %lu records lost ----", (unsigned long)(uint32_t)(rec.seq - expect));
+        }
+        expect = rec.seq + 1;
+        synced = true;
+        rd += VIEW_ALIGN(rec.size);
+        view_print(&rec, view.payload);
+    }
+    view_detach();
+    return 0;
+}
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""Query a ULog indexed store file (LOG_ENABLE_STORE, ulog_store.c).
+
+The file is memory-mapped and only the 48-byte header of each block is read
+to decide whether the block can contain a match: its time range, level mask
+and tag bitmap.  Only blocks that pass are decoded.
+
+usage: ulog_store_query.py FILE [--from T] [--to T] [--around T --window S]
+                           [--level EW] [--tag NET,UART] [--grep TEXT]
+                           [--color] [--index]
+
+T is an ISO 8601 local time (2026-10-17T14:03:05.250) or UNIX seconds.
+"""
+
+import argparse
+import mmap
+import struct
+import sys
+from datetime import datetime
+
+FILE_MAGIC = b'ULOGSTR1'
+FILE_HDR = 64
+BLOCK_MAGIC = 0x4B42534C
+BLOCK_HDR = struct.Struct('<IIQQQIHBB8x')
+LEVELS = 'AEWIDV'
+CODE_RAW = 6
+
+COLORS = {
+    'A': '\x1b[2;35m', 'E': '\x1b[2;31m', 'W': '\x1b[2;33m',
+    'I': '\x1b[2;36m', 'D': '\x1b[2;32m', 'V': '\x1b[2;37m',
+}
+RESET = '\x1b[0m'
+
+
+def read_varint(buf, pos):
+    value = shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if b < 0x80:
+            return value, pos
+        shift += 7
+
+
+def tag_bit(tag):
+    h = 2166136261
+    for c in tag.encode():
+        h = ((h ^ c) * 16777619) & 0xFFFFFFFF
+    return 1 << (h & 63)
+
+
+def parse_time(text):
+    try:
+        return int(float(text) * 1e6)
+    except ValueError:
+        return int(datetime.fromisoformat(text).timestamp() * 1e6)
+
+
+def format_time(us):
+    return datetime.fromtimestamp(us // 1000000).strftime('%Y-%m-%dT%H:%M:%S') + '.%06d' % (us % 1000000)
+
+
+def read_blocks(mm):
+    """Valid block headers in write order (oldest first)."""
+    if mm[:8] != FILE_MAGIC:
+        raise SystemExit('not a ulog store file')
+    block_size, max_blocks = struct.unpack_from('<II', mm, 8)
+    blocks = []
+    for slot in range(max_blocks):
+        off = FILE_HDR + slot * block_size
+        if off + BLOCK_HDR.size > len(mm):
+            break
+        magic, seq, first, last, bloom, used, nrec, levels, ntags = BLOCK_HDR.unpack_from(mm, off)
+        if magic != BLOCK_MAGIC or used > block_size - BLOCK_HDR.size:
+            continue
+        blocks.append((seq, off, first, last, bloom, used, nrec, levels, ntags))
+    blocks.sort()
+    return blocks
+
+
+def decode_block(mm, off, first, used):
+    """Yield (time_us, level, tag, body) for every record in a block."""
+    pos = off + BLOCK_HDR.size
+    end = pos + used
+    tags = []
+    t = first
+    while pos < end:
+        code = mm[pos]
+        pos += 1
+        tid, pos = read_varint(mm, pos)
+        if tid == len(tags):
+            n = mm[pos]
+            tags.append(mm[pos + 1:pos + 1 + n].decode('utf-8', 'replace'))
+            pos += 1 + n
+        dt, pos = read_varint(mm, pos)
+        n, pos = read_varint(mm, pos)
+        t += dt
+        body = mm[pos:pos + n].decode('utf-8', 'replace')
+        pos += n
+        yield t, (LEVELS[code] if code < len(LEVELS) else ''), tags[tid], body
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    ap.add_argument('file')
+    ap.add_argument('--from', dest='t_from', help='start time')
+    ap.add_argument('--to', dest='t_to', help='end time')
+    ap.add_argument('--around', help='center time, combined with --window')
+    ap.add_argument('--window', type=float, default=5.0, help='seconds around --around (default 5)')
+    ap.add_argument('--level', help='levels to show, e.g. EW (RAW output is shown as R)')
+    ap.add_argument('--tag', help='comma separated tags to show')
+    ap.add_argument('--grep', help='only records whose body contains TEXT')
+    ap.add_argument('--color', action='store_true', help='colorize by level')
+    ap.add_argument('--index', action='store_true', help='print the block index and exit')
+    args = ap.parse_args()
+
+    t_from = parse_time(args.t_from) if args.t_from else 0
+    t_to = parse_time(args.t_to) if args.t_to else 1 << 64
+    if args.around:
+        center = parse_time(args.around)
+        half = int(args.window * 1e6 / 2)
+        t_from, t_to = center - half, center + half
+    level_mask = 0xFF
+    if args.level:
+        level_mask = 0
+        for c in args.level.upper():
+            level_mask |= 1 << (CODE_RAW if c == 'R' else LEVELS.index(c))
+    tags = set(args.tag.split(',')) if args.tag else None
+    tag_mask = 0
+    for t in tags or ():
+        tag_mask |= tag_bit(t)
+
+    with open(args.file, 'rb') as f:
+        mm = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+    blocks = read_blocks(mm)
+
+    if args.index:
+        print('%8s %-26s %-26s %6s %-7s %5s' % ('seq', 'first', 'last', 'recs', 'levels', 'tags'))
+        for seq, off, first, last, bloom, used, nrec, levels, ntags in blocks:
+            lv = ''.join(c for i, c in enumerate(LEVELS + 'R') if levels & (1 << i))
+            print('%8d %-26s %-26s %6d %-7s %5d' % (seq, format_time(first), format_time(last), nrec, lv, ntags))
+        return
+
+    out = sys.stdout
+    scanned = 0
+    for seq, off, first, last, bloom, used, nrec, levels, ntags in blocks:
+        # 只看块头就能排除的块不解码
+        if last < t_from or first > t_to or not (levels & level_mask):
+            continue
+        if tags is not None and not (bloom & tag_mask):
+            continue
+        scanned += 1
+        for t, lv, tag, body in decode_block(mm, off, first, used):
+            if t < t_from or t > t_to:
+                continue
+            code = LEVELS.index(lv) if lv else CODE_RAW
+            if not (level_mask & (1 << code)) or (tags is not None and tag not in tags):
+                continue
+            if args.grep and args.grep not in body:
+                continue
+            if lv:
+                line = '%s [%s/%s] %s' % (format_time(t), lv, tag, body)
+            else:
+                line = '%s %s' % (format_time(t), body)
+            if args.color and lv:
+                line = COLORS[lv] + line + RESET
+            out.write(line + '\n')
+    sys.stderr.write('%d of %d blocks decoded\n' % (scanned, len(blocks)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,259 @@
+/*
+ * 并发输出压力测试：多个线程同时输出，另有一个线程不断向它们发送信号，
+ * 在信号处理函数中调用 ulog_output_isr() 模拟中断。所有日志写入一个
+ * 故意不加锁的后端，最后逐行检查：
+ *   - 没有被撕裂或混杂的行（每行的标签、线程号、填充字符和长度一致）
+ *   - 每个线程的记录按提交顺序出现，数量与丢弃统计相符
+ *   - 后端的 write 从未被并发调用
+ *
+ *   gcc -O2 -I. -DLOG_ENABLE_THREAD_SAFE=1 ulog.c tools/ulog_stress.c -o stress_sync -lpthread
+ *   gcc -O2 -I. -DLOG_ENABLE_ASYNC=1 ulog.c tools/ulog_stress.c -o stress_async -lpthread
+ *   ./stress_sync [线程数] [每线程条数]
+ * 两者都不开启时没有提交缓冲区，也就没有 ulog_output_isr()，无法编译。
+ */
+#include "ulog.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define STRESS_MAX_THREADS  32
+#define STRESS_PAD_MAX      60
+#define STRESS_OUT_SIZE     (256u * 1024 * 1024)
+
+static char             *out_buf;
+static size_t            out_len;           /* 故意不用原子操作：并发调用会损坏输出 */
+static atomic_int        out_inside;
+static atomic_uint       out_overlap;
+static atomic_uint       out_calls;
+
+static int               nthreads = 8;
+static long              count    = 50000;
+static pthread_t         workers[STRESS_MAX_THREADS];
+static atomic_int        workers_done;
+static atomic_bool       irq_stopped;
+static atomic_uint       irq_sent;
+
+static const char pad[] = "################################################################";
+
+static void stress_write(ulog_backend_t *be, unsigned char terminal, char level,
+                         const char *tag, const ulog_seg_t *seg)
+{
+    (void)be;
+    (void)terminal;
+    (void)level;
+    (void)tag;
+    if (atomic_fetch_add(&out_inside, 1) != 0) {
+        atomic_fetch_add(&out_overlap, 1);
+    }
+    for (int i = 0; i < ULOG_SEG_COUNT; i++) {
+        if (out_len + seg[i].len < STRESS_OUT_SIZE) {
+            memcpy(out_buf + out_len, seg[i].ptr, seg[i].len);
+            out_len += seg[i].len;
+        }
+        /* 在段之间让出 CPU，放大并发调用时交错的机会 */
+        if ((atomic_fetch_add_explicit(&out_calls, 1, memory_order_relaxed) & 63) == 0) {
+            sched_yield();
+        }
+    }
+    atomic_fetch_sub(&out_inside, 1);
+}
+
+static ulog_backend_t stress_backend = {
+    .name  = "stress",
+    .level = ULOG_LEVEL_VERBOSE,
+    .write = stress_write,
+};
+
+/* -------------------------------------------------------------------------- */
+/* 生产者                                                                     */
+/* -------------------------------------------------------------------------- */
+static void on_irq(int sig)
+{
+    static atomic_uint seq;
+    unsigned n = atomic_fetch_add_explicit(&seq, 1, memory_order_relaxed);
+
+    (void)sig;
+    ulog_output_isr(ULOG_RTT_TERMINAL_ID, 'W', "IRQ", "I %07u %.*s|\r\n",
+                    n, (int)(n % 20), pad);
+}
+
+static void *worker(void *arg)
+{
+    long id = (long)arg;
+    char tag[8];
+
+    snprintf(tag, sizeof(tag), "T%02ld", id);
+    for (long i = 0; i < count; i++) {
+        int plen = (int)((i * 7 + id) % STRESS_PAD_MAX);
+        ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'I', tag, "T%02ld %07ld %.*s|\r\n",
+                       id, i, plen, pad);
+    }
+    /* 信号源停止之前线程不能退出，否则 pthread_kill 的目标无效 */
+    atomic_fetch_add(&workers_done, 1);
+    while (!atomic_load(&irq_stopped)) {
+        usleep(1000);
+    }
+    return NULL;
+}
+
+static void *irq_source(void *arg)
+{
+    unsigned r = 1;
+
+    (void)arg;
+    while (atomic_load(&workers_done) < nthreads) {
+        r = r * 1103515245u + 12345u;
+        if (pthread_kill(workers[(r >> 16) % (unsigned)nthreads], SIGUSR1) == 0) {
+            atomic_fetch_add(&irq_sent, 1);
+        }
+        usleep(50);
+    }
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/* 检查                                                                       */
+/* -------------------------------------------------------------------------- */
+/* 跳过可选的时间戳 "[...] " */
+static const char *skip_ts(const char *p)
+{
+    if (*p == '[') {
+        const char *e = strstr(p, "] ");
+        if (e != NULL) {
+            return e + 2;
+        }
+    }
+    return p;
+}
+
+static bool pad_ok(const char *p, int n)
+{
+    for (int i = 0; i < n; i++) {
+        if (p[i] != '#') {
+            return false;
+        }
+    }
+    return p[n] == '|' && p[n + 1] == '\0';
+}
+
+int main(int argc, char **argv)
+{
+    long next[STRESS_MAX_THREADS] = { 0 };
+    long seen[STRESS_MAX_THREADS] = { 0 };
+    unsigned long torn = 0, disorder = 0, irq_lines = 0, lines = 0;
+    unsigned char *irq_seen;
+    pthread_t irq;
+    struct sigaction sa;
+
+    if (argc > 1) {
+        nthreads = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        count = atol(argv[2]);
+    }
+    if (nthreads < 1 || nthreads > STRESS_MAX_THREADS) {
+        nthreads = 8;
+    }
+    out_buf = malloc(STRESS_OUT_SIZE);
+    if (out_buf == NULL) {
+        return 1;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_irq;
+    sa.sa_flags   = SA_RESTART;
+    sigaction(SIGUSR1, &sa, NULL);
+
+    ulog_init();
+    ulog_flush();       /* 启动 logo 输出完再换后端 */
+    if (ulog_backend_find("printf") != NULL) {
+        ulog_backend_unregister(ulog_backend_find("printf"));
+    }
+    ulog_backend_register(&stress_backend);
+
+    for (long i = 0; i < nthreads; i++) {
+        pthread_create(&workers[i], NULL, worker, (void *)i);
+    }
+    pthread_create(&irq, NULL, irq_source, NULL);
+    pthread_join(irq, NULL);
+    usleep(10000);      /* 等最后一个信号处理完 */
+    atomic_store(&irq_stopped, true);
+    for (int i = 0; i < nthreads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    ulog_flush();
+    ulog_deinit();
+
+    /* 逐行解析 */
+    out_buf[out_len] = '\0';
+    irq_seen = calloc(atomic_load(&irq_sent) + 1, 1);
+    for (char *line = out_buf, *end; *line; line = end + 2) {
+        end = strstr(line, "\r\n");
+        if (end == NULL) {
+            torn++;
+            break;
+        }
+        *end = '\0';
+        lines++;
+
+        int id, n;
+        long seq;
+        char tag[8];
+        if (sscanf(line, "[I/T%2d] ", &id) == 1 && line[6] == ']') {
+            const char *p = skip_ts(line + 8);
+            snprintf(tag, sizeof(tag), "T%02d ", id);
+            if (id < 0 || id >= nthreads || strncmp(p, tag, 4) != 0 ||
+                sscanf(p + 4, "%7ld %n", &seq, &n) != 1 ||
+                !pad_ok(p + 4 + n, (int)((seq * 7 + id) % STRESS_PAD_MAX))) {
+                torn++;
+                continue;
+            }
+            if (seq < next[id]) {
+                disorder++;
+            }
+            next[id] = seq + 1;
+            seen[id]++;
+        } else if (strncmp(line, "[W/IRQ] ", 8) == 0) {
+            const char *p = skip_ts(line + 8);
+            if (sscanf(p, "I %7ld %n", &seq, &n) != 1 || !pad_ok(p + n, (int)(seq % 20)) ||
+                seq < 0 || seq > (long)atomic_load(&irq_sent)) {
+                torn++;
+                continue;
+            }
+            /* 信号处理函数之间可能嵌套，不要求顺序，只要求不重复 */
+            if (irq_seen[seq]++) {
+                disorder++;
+            }
+            irq_lines++;
+        } else if (strncmp(line, "[W/ULOG] ", 9) == 0 && strstr(line, " records dropped")) {
+            /* 丢弃汇总，数量以统计为准 */
+        } else {
+            torn++;
+        }
+    }
+
+    unsigned long missing = 0;
+    for (int i = 0; i < nthreads; i++) {
+        missing += (unsigned long)(count - seen[i]);
+    }
+
+    ulog_async_stats_t st = { 0 };
+#if LOG_ENABLE_ASYNC || LOG_ENABLE_THREAD_SAFE
+    ulog_async_get_stats(&st);
+#endif
+    unsigned long lost = st.dropped + st.overwritten + st.dropped_error;
+    bool ok = torn == 0 && disorder == 0 && atomic_load(&out_overlap) == 0 &&
+              missing <= lost && irq_lines <= atomic_load(&irq_sent);
+
+    fprintf(stderr, "%s: %d threads x %ld, %lu lines, %lu irq lines (%u sent), "
+            "torn %lu, disorder %lu, overlap %u, missing %lu, dropped %lu\n",
+            ok ? "PASS" : "FAIL", nthreads, count, lines, irq_lines, atomic_load(&irq_sent),
+            torn, disorder, atomic_load(&out_overlap), missing, lost);
+    free(irq_seen);
+    free(out_buf);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+/*
+ * syslog 后端吞吐量测试：在 127.0.0.1 上起一个 UDP 接收端，统计收到的报文数
+ * 和记录数，比较合并报文与每条一个报文两种方式。
+ *
+ * 在命令行打开 syslog 后端，分别编译合并报文和每条一个报文两个版本：
+ *   gcc -O2 -I. -DLOG_ENABLE_NETWORK=1 -DLOG_NETWORK_BATCH=1 \
+ *       ulog.c ulog_syslog.c tools/ulog_syslog_bench.c -o bench_batch -lpthread
+ *   gcc -O2 -I. -DLOG_ENABLE_NETWORK=1 -DLOG_NETWORK_BATCH=0 \
+ *       ulog.c ulog_syslog.c tools/ulog_syslog_bench.c -o bench_single -lpthread
+ *   ./bench_batch [条数]
+ */
+#include "ulog.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#if !LOG_ENABLE_NETWORK
+#error "build with -DLOG_ENABLE_NETWORK=1"
+#endif
+
+static int               rx_fd;
+static volatile bool     rx_stop;
+static volatile unsigned long rx_dgrams, rx_records, rx_bytes;
+
+static double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void *rx_task(void *arg)
+{
+    char buf[65536];
+
+    (void)arg;
+    while (!rx_stop) {
+        ssize_t n = recv(rx_fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            continue;
+        }
+        rx_dgrams++;
+        rx_bytes += (unsigned long)n;
+        rx_records++;
+        for (ssize_t i = 0; i < n; i++) {
+            rx_records += (buf[i] == '\n');
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    long count = (argc > 1) ? atol(argv[1]) : 200000;
+    struct sockaddr_in sa = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t sl = sizeof(sa);
+    struct timeval tv = { 0, 100000 };
+    int rcvbuf = 8 * 1024 * 1024;
+    pthread_t th;
+
+    rx_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    setsockopt(rx_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    setsockopt(rx_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if (bind(rx_fd, (struct sockaddr *)&sa, sizeof(sa)) != 0 ||
+        getsockname(rx_fd, (struct sockaddr *)&sa, &sl) != 0) {
+        perror("bind");
+        return 1;
+    }
+    pthread_create(&th, NULL, rx_task, NULL);
+
+    ulog_syslog_set_server("127.0.0.1", ntohs(sa.sin_port));
+    ulog_init();
+    if (ulog_backend_find("printf") != NULL) {
+        ulog_backend_find("printf")->level = ULOG_LEVEL_ASSERT;
+    }
+
+    double t0 = bench_now();
+    for (long i = 0; i < count; i++) {
+        ULOG_I_TAG("BENCH", "sensor %ld value=%d status=0x%08x\r\n", i, (int)(i * 7), (unsigned)i);
+    }
+    ulog_flush();
+    double dt = bench_now() - t0;
+
+    usleep(300000);
+    rx_stop = true;
+    pthread_join(th, NULL);
+
+    fprintf(stderr, "%s: %10.0f msg/s  %.0f ns/msg  datagrams %lu  received %lu/%ld  (%.1f MB)  tx drops %lu\n",
+            LOG_NETWORK_BATCH ? "batched" : "single ", count / dt, dt * 1e9 / count,
+            rx_dgrams, rx_records, count, rx_bytes / 1e6, (unsigned long)ulog_syslog_get_dropped());
+    ulog_deinit();
+    return 0;
+}
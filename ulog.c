@@ -1,6 +1,102 @@
 #include "ulog.h"
 
+/* 첽ģʽ̰߳ȫͬģʽͬһύ */
+#define ULOG_USE_RING       (LOG_ENABLE_ASYNC || LOG_ENABLE_THREAD_SAFE)
+/* ʱٺꡢʱͳ/ָܺ printf ĳʱдʱԴ */
+#define ULOG_USE_CLOCK      (ULOG_WITH_TIMESTAMP || LOG_ENABLE_RATE_LIMIT || (LOG_ENABLE_STATS && LOG_STATS_DUMP_MS) || \
+                             (LOG_PRINTF_BUFFERED && LOG_PRINTF_FLUSH_MS) || (LOG_ENABLE_METRIC && LOG_METRIC_PERIOD_MS))
+#define ULOG_USE_DEDUP      (LOG_ENABLE_RATE_LIMIT && LOG_DEDUP_ENABLE)
+/* ־ TLV ʽĽṹ־öƼ¼ı */
+#define ULOG_USE_BIN_OUT    (LOG_ENABLE_BINARY || (LOG_ENABLE_KV && (LOG_KV_FORMAT == ULOG_KV_TLV)))
 
+/* log_output_v ǿδ־ͳʱ ulog_output_ex һκ */
+#if defined(__GNUC__) || defined(__clang__)
+#define ULOG_ALWAYS_INLINE  inline __attribute__((always_inline))
+#else
+#define ULOG_ALWAYS_INLINE  inline
+#endif
+
+#if ULOG_USE_RING || LOG_ENABLE_RUNTIME_LEVEL_CONTROL || LOG_ENABLE_FILTER || ULOG_WITH_TIMESTAMP || \
+    LOG_ENABLE_RECORD_POOL || LOG_ENABLE_STATS || LOG_ENABLE_FLIGHT || LOG_ENABLE_METRIC || ULOG_USE_DEDUP
+#include <stdatomic.h>
+#endif
+#if LOG_ENABLE_STATS && ULOG_PORT_POSIX && !defined(LOG_STATS_CYCLES)
+#include <time.h>
+#endif
+#include <limits.h>
+#include <wchar.h>          /* %ls / %lc Ĳ */
+
+#if ULOG_USE_CLOCK
+#if (ULOG_TS_SOURCE == ULOG_TS_SOURCE_MONOTONIC)
+#include <time.h>
+#elif (ULOG_TS_SOURCE == ULOG_TS_SOURCE_TICK) || (ULOG_TS_SOURCE == ULOG_TS_SOURCE_DWT)
+#include ULOG_TS_DEVICE_HEADER
+#endif
+#endif
+
+#if LOG_PRINTF_BUFFERED && ULOG_PORT_POSIX
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#if ULOG_USE_RING
+#if ULOG_PORT_POSIX
+#include <sched.h>
+#include <time.h>
+#endif
+#if LOG_ENABLE_ASYNC && ULOG_PORT_POSIX
+#include <pthread.h>
+#include <semaphore.h>
+#elif LOG_ENABLE_ASYNC
+#include "cmsis_os2.h"
+#ifndef LOG_THREAD_ID
+#define LOG_THREAD_ID()     ((const void *)osThreadGetId())
+#endif
+#elif !ULOG_PORT_POSIX && !defined(LOG_THREAD_YIELD)
+/* ͬģʽʱó CPUóĻڰȼռ RTOS ռſռ
+ * ȼԶò */
+#include "cmsis_os2.h"
+#define LOG_THREAD_YIELD()  osDelay(1)
+#ifndef LOG_THREAD_ID
+#define LOG_THREAD_ID()     ((const void *)osThreadGetId())
+#endif
+#endif
+#if ULOG_PORT_POSIX && !defined(LOG_THREAD_ID)
+/* ֲ߳̾ĵַ̱߳ʶ */
+static _Thread_local char ulog_thread_marker;
+#define LOG_THREAD_ID()     ((const void *)&ulog_thread_marker)
+#endif
+
+static void log_ring_start(void);
+static void log_ring_stop(void);
+static void log_ring_flush(void);
+#endif
+
+static void log_backends_init(void);
+static void log_backends_deinit(void);
+#if ULOG_USE_CLOCK && (ULOG_TS_SOURCE == ULOG_TS_SOURCE_DWT)
+static void ts_init(void);
+#endif
+#if LOG_ENABLE_RECORD_POOL
+static void pool_init(void);
+#endif
+#if ULOG_USE_DEDUP
+static void dedup_report(void);
+#if ULOG_USE_RING
+static void dedup_idle(bool requested);
+#endif
+#endif
+#if LOG_ENABLE_STATS && LOG_STATS_DUMP_MS
+static void stats_init(void);
+#endif
+#if LOG_ENABLE_METRIC && LOG_METRIC_PERIOD_MS
+static void metric_init(void);
+#endif
+#if LOG_ENABLE_FLIGHT
+static void flight_pending_flush(void);
+#endif
 
 /* -------------------------------------------------------------------------- */
 /* ʼ/ʼ                                                        */
@@ -9,12 +105,24 @@ void ulog_init(void)
 {
 #if !ULOG_OUTPUT_DISABLE
 
-#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_RTT)
-	SEGGER_RTT_Init();
+#if ULOG_USE_CLOCK && (ULOG_TS_SOURCE == ULOG_TS_SOURCE_DWT)
+	ts_init();
 #endif
-#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_EASYLOGGER)
-	elog_init();
-	elog_start();
+#if LOG_ENABLE_RECORD_POOL
+	pool_init();
+#endif
+#if LOG_ENABLE_STATS && LOG_STATS_DUMP_MS
+	stats_init();
+#endif
+#if LOG_ENABLE_METRIC && LOG_METRIC_PERIOD_MS
+	metric_init();
+#endif
+	log_backends_init();
+#if LOG_ENABLE_CRASH_LOG
+	ulog_crash_init();	/* Ѿύδϴεͬط */
+#endif
+#if ULOG_USE_RING
+	log_ring_start();
 #endif
 
 #if ULOG_SHOW_LOG
@@ -34,79 +142,729 @@ void ulog_deinit(void)
 {
 #if !ULOG_OUTPUT_DISABLE
 
-#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_EASYLOGGER)
-	elog_stop();
-	elog_deinit();
+#if ULOG_USE_RING
+	log_ring_stop();	/* ʣ־ */
 #endif
+#if ULOG_USE_DEDUP
+	dedup_report();		/* δظ */
+#endif
+#if LOG_ENABLE_CRASH_LOG
+	ulog_crash_deinit();	/* Ϊ */
+#endif
+	log_backends_deinit();
 
 #endif
 }
 
 /* -------------------------------------------------------------------------- */
-/* ڲʽ־Ϣ                                                   */
+/* ڲʽ                                                   */
 /* -------------------------------------------------------------------------- */
-static int format_log_message(char *buf, size_t size,
-                                     char level, const char *tag,
-                                     const char *fmt, va_list args)
+/* ֱӴ %d %i %u %x %X %o %c %s %p %% ñ־///η
+ * ת snprintfתʱʣಿֽ vsnprintf
+ * д붼߽飬buf ʼ '\0' β */
+typedef struct {
+    char   *buf;
+    size_t  size;       /* дַ */
+    size_t  len;
+    bool    truncated;
+} ulog_out_t;
+
+static inline void out_char(ulog_out_t *o, char c)
 {
-    int len = 0;
+    if (o->len < o->size) {
+        o->buf[o->len++] = c;
+    } else {
+        o->truncated = true;
+    }
+}
 
-    /* ʽ[E/TAG]  [TAG] */
-    if (level && tag && *tag) {
-        len = snprintf(buf, size, "[%c/%s] ", level, tag);
-    } else if (tag && *tag) {
-        len = snprintf(buf, size, "[%s] ", tag);
+static inline void out_mem(ulog_out_t *o, const char *s, size_t n)
+{
+    if (n > o->size - o->len) {
+        n = o->size - o->len;
+        o->truncated = true;
     }
+    memcpy(o->buf + o->len, s, n);
+    o->len += n;
+}
 
-	#if ULOG_WITH_TIMESTAMP
-	char ts[64];
-    ulog_get_timestamp_str(ts, sizeof(ts));
-    len += snprintf(buf + len, size - len, "%s ", ts);
-	#endif
+static inline void out_fill(ulog_out_t *o, char c, int n)
+{
+    while (n-- > 0) {
+        out_char(o, c);
+    }
+}
 
-    /* ׷ʵ־ */
-    len += vsnprintf(buf + len, size - len, fmt, args);
+#define FMT_LEFT    0x01
+#define FMT_ZERO    0x02
+#define FMT_PLUS    0x04
+#define FMT_SPACE   0x08
+#define FMT_ALT     0x10
 
-	#if 0
-    /* ׷ӻ */
-    len += snprintf(buf + len, size - len, "\r\n");
-	#endif
+/* һprefix ΪŻ 0x ǰ׺ */
+static void out_number(ulog_out_t *o, unsigned long long v, unsigned base, bool upper,
+                       const char *prefix, unsigned flags, int width, int prec)
+{
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char tmp[24];
+    int n = 0;
 
-    return len;
+    /* 32 λֵ߿· MCU ϵ 64 λ */
+    if (v <= 0xFFFFFFFFu) {
+        uint32_t x = (uint32_t)v;
+        do {
+            tmp[n++] = digits[x % base];
+            x /= base;
+        } while (x);
+    } else {
+        do {
+            tmp[n++] = digits[v % base];
+            v /= base;
+        } while (v);
+    }
+    if (prec == 0 && n == 1 && tmp[0] == '0') {
+        n = 0;          /* printf("%.0d", 0) մ */
+    }
+
+    int plen = (int)strlen(prefix);
+    int zeros = (prec > n) ? prec - n : 0;
+    int pad = width - plen - zeros - n;
+
+    if (!(flags & FMT_LEFT)) {
+        if ((flags & FMT_ZERO) && prec < 0) {
+            zeros += (pad > 0) ? pad : 0;
+        } else {
+            out_fill(o, ' ', pad);
+        }
+        pad = 0;
+    }
+    out_mem(o, prefix, (size_t)plen);
+    out_fill(o, '0', zeros);
+    while (n) {
+        out_char(o, tmp[--n]);
+    }
+    out_fill(o, ' ', pad);
+}
+
+/* ֻһת˵Ⱥ;ȡд룩ת snprintf */
+static void fmt_spec(char *fs, size_t size, unsigned flags, int width, int prec, const char *lm, char conv)
+{
+    int k = snprintf(fs, size, "%%%s%s%s%s%s",
+                     (flags & FMT_LEFT) ? "-" : "", (flags & FMT_ZERO) ? "0" : "",
+                     (flags & FMT_PLUS) ? "+" : "", (flags & FMT_SPACE) ? " " : "",
+                     (flags & FMT_ALT) ? "#" : "");
+    if (width > 0) {
+        k += snprintf(fs + k, size - (size_t)k, "%d", width);
+    }
+    if (prec >= 0) {
+        k += snprintf(fs + k, size - (size_t)k, ".%d", prec);
+    }
+    snprintf(fs + k, size - (size_t)k, "%s%c", lm, conv);
+}
+
+/* snprintf д o->buf + o->lenֵ³ */
+static void out_commit(ulog_out_t *o, int n)
+{
+    if (n > 0) {
+        if ((size_t)n > o->size - o->len) {
+            n = (int)(o->size - o->len);
+            o->truncated = true;
+        }
+        o->len += (size_t)n;
+    }
+}
+
+static void ulog_vformat(ulog_out_t *o, const char *fmt, va_list args)
+{
+    const char *f = fmt;
+
+    while (*f) {
+        /* ַͨɶο */
+        const char *start = f;
+        while (*f && *f != '%') {
+            f++;
+        }
+        out_mem(o, start, (size_t)(f - start));
+        if (*f == '\0') {
+            break;
+        }
+
+        const char *spec = f++;
+        unsigned flags = 0;
+        int width = 0;
+        int prec = -1;
+        char lm = 0;
+        bool star = false;
+        va_list at_spec;        /*  * ʱȡ/֮ǰĲλã vsnprintf ʹ */
+
+        for (;; f++) {
+            if      (*f == '-') flags |= FMT_LEFT;
+            else if (*f == '0') flags |= FMT_ZERO;
+            else if (*f == '+') flags |= FMT_PLUS;
+            else if (*f == ' ') flags |= FMT_SPACE;
+            else if (*f == '#') flags |= FMT_ALT;
+            else break;
+        }
+        if (*f == '*') {
+            va_copy(at_spec, args);
+            star = true;
+            width = va_arg(args, int);
+            if (width < 0) {
+                flags |= FMT_LEFT;
+                width = -width;
+            }
+            f++;
+        } else {
+            while (*f >= '0' && *f <= '9') {
+                width = width * 10 + (*f++ - '0');
+            }
+        }
+        if (*f == '.') {
+            f++;
+            prec = 0;
+            if (*f == '*') {
+                if (!star) {
+                    va_copy(at_spec, args);
+                    star = true;
+                }
+                prec = va_arg(args, int);
+                prec = (prec < 0) ? -1 : prec;
+                f++;
+            } else {
+                while (*f >= '0' && *f <= '9') {
+                    prec = prec * 10 + (*f++ - '0');
+                }
+            }
+        }
+        switch (*f) {
+            case 'h': lm = 'h'; f++; if (*f == 'h') { lm = 'H'; f++; } break;
+            case 'l': lm = 'l'; f++; if (*f == 'l') { lm = 'q'; f++; } break;
+            case 'j': lm = 'q'; f++; break;
+            case 'z': case 't': lm = 'z'; f++; break;
+            case 'L': lm = 'L'; f++; break;
+            default : break;
+        }
+
+        switch (*f) {
+            case 'd': case 'i': {
+                long long v;
+                if      (lm == 'q') v = va_arg(args, long long);
+                else if (lm == 'l') v = va_arg(args, long);
+                else if (lm == 'z') v = va_arg(args, intptr_t);
+                else if (lm == 'h') v = (short)va_arg(args, int);
+                else if (lm == 'H') v = (signed char)va_arg(args, int);
+                else                v = va_arg(args, int);
+                const char *sign = (v < 0) ? "-" : (flags & FMT_PLUS) ? "+" : (flags & FMT_SPACE) ? " " : "";
+                unsigned long long u = (v < 0) ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+                out_number(o, u, 10, false, sign, flags, width, prec);
+                break;
+            }
+            case 'u': case 'x': case 'X': case 'o': {
+                unsigned long long v;
+                if      (lm == 'q') v = va_arg(args, unsigned long long);
+                else if (lm == 'l') v = va_arg(args, unsigned long);
+                else if (lm == 'z') v = va_arg(args, size_t);
+                else if (lm == 'h') v = (unsigned short)va_arg(args, unsigned int);
+                else if (lm == 'H') v = (unsigned char)va_arg(args, unsigned int);
+                else                v = va_arg(args, unsigned int);
+                unsigned base = (*f == 'o') ? 8 : (*f == 'u') ? 10 : 16;
+                const char *prefix = "";
+                if ((flags & FMT_ALT) && v != 0) {
+                    prefix = (*f == 'x') ? "0x" : (*f == 'X') ? "0X" : (*f == 'o') ? "0" : "";
+                }
+                out_number(o, v, base, *f == 'X', prefix, flags, width, prec);
+                break;
+            }
+            case 'p':
+                out_number(o, (uintptr_t)va_arg(args, void *), 16, false, "0x", flags, width, -1);
+                break;
+            case 'c': {
+                if (lm == 'l') {
+                    /* ַǰ locale  C ת */
+                    char fs[40];
+                    fmt_spec(fs, sizeof(fs), flags, width, prec, "l", 'c');
+                    out_commit(o, snprintf(o->buf + o->len, o->size - o->len + 1, fs, va_arg(args, wint_t)));
+                    break;
+                }
+                char c = (char)va_arg(args, int);
+                if (!(flags & FMT_LEFT)) out_fill(o, ' ', width - 1);
+                out_char(o, c);
+                if (flags & FMT_LEFT) out_fill(o, ' ', width - 1);
+                break;
+            }
+            case 's': {
+                if (lm == 'l') {
+                    char fs[40];
+                    fmt_spec(fs, sizeof(fs), flags, width, prec, "l", 's');
+                    out_commit(o, snprintf(o->buf + o->len, o->size - o->len + 1, fs,
+                                           va_arg(args, const wchar_t *)));
+                    break;
+                }
+                const char *s = va_arg(args, const char *);
+                size_t n = 0;
+                if (s == NULL) {
+                    s = "(null)";
+                }
+                while (s[n] && (prec < 0 || n < (size_t)prec)) {
+                    n++;
+                }
+                if (!(flags & FMT_LEFT)) out_fill(o, ' ', width - (int)n);
+                out_mem(o, s, n);
+                if (flags & FMT_LEFT) out_fill(o, ' ', width - (int)n);
+                break;
+            }
+            case '%':
+                out_char(o, '%');
+                break;
+            case 'f': case 'F': case 'e': case 'E':
+            case 'g': case 'G': case 'a': case 'A': {
+                /* ֻһת snprintf */
+                char fs[40];
+                fmt_spec(fs, sizeof(fs), flags, width, prec, (lm == 'L') ? "L" : "", *f);
+                int n = (lm == 'L') ? snprintf(o->buf + o->len, o->size - o->len + 1, fs, va_arg(args, long double))
+                                    : snprintf(o->buf + o->len, o->size - o->len + 1, fs, va_arg(args, double));
+                out_commit(o, n);
+                break;
+            }
+            default: {
+                /* ټתʣಿֽ vsnprintfȡ * ת˵¶ȡ */
+                int n;
+                if (star) {
+                    n = vsnprintf(o->buf + o->len, o->size - o->len + 1, spec, at_spec);
+                    va_end(at_spec);
+                } else {
+                    n = vsnprintf(o->buf + o->len, o->size - o->len + 1, spec, args);
+                }
+                out_commit(o, n);
+                return;
+            }
+        }
+        if (star) {
+            va_end(at_spec);
+        }
+        f++;
+    }
+}
+
+#if LOG_ENABLE_FLIGHT || LOG_ENABLE_BINARY
+/* %ls ڼ¼ʱתɶֽڴǰ locale֮ %s һ棻Ų»޷תַʱֹͣ
+ * ǰ *trunc */
+static size_t wcs_to_mb(char *dst, size_t size, const wchar_t *ws, bool *trunc)
+{
+    mbstate_t st;
+    size_t n = 0;
+
+    memset(&st, 0, sizeof(st));
+    for (; ws != NULL && *ws; ws++) {
+        char mb[MB_LEN_MAX];
+        size_t k = wcrtomb(mb, *ws, &st);
+        if (k == (size_t)-1) {
+            break;
+        }
+        if (k > size - n) {
+            *trunc = true;
+            break;
+        }
+        memcpy(dst + n, mb, k);
+        n += k;
+    }
+    return n;
 }
+#endif
 
+#if ULOG_USE_CLOCK
 /* -------------------------------------------------------------------------- */
-/* ڲ RTT                                                       */
+/* ʱʱԴ                                                             */
 /* -------------------------------------------------------------------------- */
-static void log_backend_rtt(unsigned char terminal, char level, const char *msg)
+/* ʱԴֱӸ  + ΢룬Ⱦ·ϲҪ 64 λ */
+#if (ULOG_TS_SOURCE == ULOG_TS_SOURCE_MONOTONIC)
+static void ts_now(uint32_t *sec, uint32_t *usec)
 {
-#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_RTT) && (SUPPORT_SEGGER_RTT == 1)
-    SEGGER_RTT_SetTerminal(terminal);
-  #if ULOG_COLOR_ENABLE
-    if (level) {
-        SEGGER_RTT_WriteString(0, ULOG_COLOR_RESET);
-        SEGGER_RTT_WriteString(0, ULOG_GET_COLOR(level));
-        SEGGER_RTT_WriteString(0, msg);
-        SEGGER_RTT_WriteString(0, ULOG_COLOR_RESET);
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    *sec  = (uint32_t)ts.tv_sec;
+    *usec = (uint32_t)(ts.tv_nsec / 1000);
+}
+
+#elif (ULOG_TS_SOURCE == ULOG_TS_SOURCE_TICK)
+static void ts_now(uint32_t *sec, uint32_t *usec)
+{
+    uint32_t tick = HAL_GetTick();
+    *sec  = tick / 1000u;
+    *usec = (tick % 1000u) * 1000u;
+}
+
+#elif (ULOG_TS_SOURCE == ULOG_TS_SOURCE_DWT)
+/* 32 λڼٽۼΪ  +  */
+static struct {
+    uint32_t last;
+    uint32_t sec;
+    uint32_t cyc;
+} ulog_dwt;
+
+static void ts_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    ulog_dwt.last = 0;
+}
+
+static void ts_now(uint32_t *sec, uint32_t *usec)
+{
+    uint32_t hz = (uint32_t)(ULOG_TS_CPU_HZ);
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    uint32_t now = DWT->CYCCNT;
+    ulog_dwt.cyc += now - ulog_dwt.last;
+    ulog_dwt.last = now;
+    while (ulog_dwt.cyc >= hz) {
+        ulog_dwt.cyc -= hz;
+        ulog_dwt.sec++;
+    }
+    *sec  = ulog_dwt.sec;
+    *usec = ulog_dwt.cyc / (hz / 1000000u);
+    __set_PRIMASK(primask);
+}
+
+#elif (ULOG_TS_SOURCE == ULOG_TS_SOURCE_USER)
+#define ts_now(sec, usec)   ulog_timestamp_source(sec, usec)
+#else
+#error "unknown ULOG_TS_SOURCE"
+#endif
+
+uint32_t ulog_get_timestamp(void)
+{
+    uint32_t sec, usec;
+    ts_now(&sec, &usec);
+    return sec * 1000u + usec / 1000u;
+}
+
+uint64_t ulog_get_timestamp_us(void)
+{
+    uint32_t sec, usec;
+    ts_now(&sec, &usec);
+    return (uint64_t)sec * 1000000u + usec;
+}
+#endif /* ULOG_USE_CLOCK */
+
+#if LOG_ENABLE_RATE_LIMIT
+/* -------------------------------------------------------------------------- */
+/* ٣ULOG_x_EVERY_MS / ULOG_x_THROTTLE ĵõ״̬                       */
+/* -------------------------------------------------------------------------- */
+/* ״̬ɵõ㾲̬䣬ͬʱͬһõʱһ */
+bool ulog_rate_every(ulog_rate_t *r, uint32_t ms)
+{
+    uint32_t now = ulog_get_timestamp();
+
+    if (r->primed && now - r->last < ms) {
+        return false;
+    }
+    r->primed = true;
+    r->last   = now;
+    return true;
+}
+
+/* Ͱ 1/1000 Ϊλÿ벹 per_sec  burst  */
+bool ulog_rate_take(ulog_rate_t *r, uint32_t per_sec, uint32_t burst)
+{
+    uint32_t now = ulog_get_timestamp();
+    uint32_t cap = burst * 1000u;
+
+    if (!r->primed) {
+        r->primed = true;
+        r->tokens = cap;
     } else {
-        SEGGER_RTT_WriteString(0, msg);
+        uint64_t t = (uint64_t)(now - r->last) * per_sec + r->tokens;
+        r->tokens = (t < cap) ? (uint32_t)t : cap;
+    }
+    r->last = now;
+    if (r->tokens < 1000u) {
+        return false;
+    }
+    r->tokens -= 1000u;
+    return true;
+}
+#endif /* LOG_ENABLE_RATE_LIMIT */
+
+#if ULOG_WITH_TIMESTAMP
+/* -------------------------------------------------------------------------- */
+/* ʱȾ                                                               */
+/* -------------------------------------------------------------------------- */
+/* "[DDd-HHh:MMm:SSs^" ÿֻһβ棬ÿ־ֻд루΢룩֡
+ * űΪżǰһʱʹûݣδеĵ
+ * ɣʱ»棬κʱ򶼲ȴ */
+#if (ULOG_TIMESTAMP_FORMAT != 0)
+#define ULOG_TS_WORDS       6       /*  "[49710d-23h:59m:59s^" = 20 ֽ */
+
+static struct {
+    atomic_uint seq;
+    atomic_uint sec;
+    atomic_uint len;
+    atomic_uint text[ULOG_TS_WORDS];
+} ulog_ts_cache = { .sec = UINT32_MAX };
+
+static size_t ts_render_day(uint32_t sec, char *out)
+{
+    ulog_out_t o = { out, ULOG_TS_WORDS * 4, 0, false };
+
+    out_char(&o, '[');
+    out_number(&o, sec / 86400u, 10, false, "", FMT_ZERO, 2, -1);
+    out_mem(&o, "d-", 2);
+    out_number(&o, sec / 3600u % 24u, 10, false, "", FMT_ZERO, 2, -1);
+    out_mem(&o, "h:", 2);
+    out_number(&o, sec / 60u % 60u, 10, false, "", FMT_ZERO, 2, -1);
+    out_mem(&o, "m:", 2);
+    out_number(&o, sec % 60u, 10, false, "", FMT_ZERO, 2, -1);
+    out_mem(&o, "s^", 2);
+    return o.len;
+}
+
+static size_t ts_day_part(uint32_t sec, char *out)
+{
+    uint32_t words[ULOG_TS_WORDS];
+    unsigned s = atomic_load_explicit(&ulog_ts_cache.seq, memory_order_acquire);
+
+    if (!(s & 1u) && atomic_load_explicit(&ulog_ts_cache.sec, memory_order_relaxed) == sec) {
+        size_t len = atomic_load_explicit(&ulog_ts_cache.len, memory_order_relaxed);
+        for (int i = 0; i < ULOG_TS_WORDS; i++) {
+            words[i] = atomic_load_explicit(&ulog_ts_cache.text[i], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&ulog_ts_cache.seq, memory_order_relaxed) == s &&
+            len <= sizeof(words)) {
+            memcpy(out, words, len);
+            return len;
+        }
+    }
+
+    size_t len = ts_render_day(sec, (char *)words);
+    memcpy(out, words, len);
+    if (!(s & 1u) &&
+        atomic_compare_exchange_strong_explicit(&ulog_ts_cache.seq, &s, s + 1,
+                                                memory_order_acquire, memory_order_relaxed)) {
+        atomic_thread_fence(memory_order_release);
+        atomic_store_explicit(&ulog_ts_cache.sec, sec, memory_order_relaxed);
+        atomic_store_explicit(&ulog_ts_cache.len, (unsigned)len, memory_order_relaxed);
+        for (int i = 0; i < ULOG_TS_WORDS; i++) {
+            atomic_store_explicit(&ulog_ts_cache.text[i], words[i], memory_order_relaxed);
+        }
+        atomic_store_explicit(&ulog_ts_cache.seq, s + 2, memory_order_release);
     }
+    return len;
+}
+#endif
+
+/* дʱβո */
+static void log_put_timestamp_at(ulog_out_t *o, uint32_t sec, uint32_t usec)
+{
+#if (ULOG_TIMESTAMP_FORMAT == 0)
+    out_char(o, '[');
+    out_number(o, (unsigned long long)sec * 1000u + usec / 1000u, 10, false, "", 0, 0, -1);
+    out_mem(o, " ms]", 4);
+#else
+    char t[ULOG_TS_WORDS * 4 + 12];
+    size_t n = ts_day_part(sec, t);
+    uint32_t ms = usec / 1000u;
 
-	/* ȷںʱɫ */
-    SEGGER_RTT_WriteString(0,ULOG_CTRL_RESET"");
-  #else
-    SEGGER_RTT_WriteString(0, msg);
+    t[n++] = (char)('0' + ms / 100u);
+    t[n++] = (char)('0' + ms / 10u % 10u);
+    t[n++] = (char)('0' + ms % 10u);
+  #if (ULOG_TIMESTAMP_FORMAT == 2)
+    uint32_t us = usec % 1000u;
+    t[n++] = '.';
+    t[n++] = (char)('0' + us / 100u);
+    t[n++] = (char)('0' + us / 10u % 10u);
+    t[n++] = (char)('0' + us % 10u);
   #endif
+    t[n++] = 'm';
+    t[n++] = 's';
+    t[n++] = ']';
+    out_mem(o, t, n);
 #endif
 }
 
+static void log_put_timestamp(ulog_out_t *o)
+{
+    uint32_t sec, usec;
+
+    ts_now(&sec, &usec);
+    log_put_timestamp_at(o, sec, usec);
+}
+
+void ulog_get_timestamp_str(char *buf, size_t size)
+{
+    ulog_out_t o = { buf, size - 1, 0, false };
+
+    if (size == 0) {
+        return;
+    }
+    log_put_timestamp(&o);
+    buf[o.len] = '\0';
+}
+#endif /* ULOG_WITH_TIMESTAMP */
+
+/* -------------------------------------------------------------------------- */
+/* ڲʽ־Ϣ                                                   */
+/* -------------------------------------------------------------------------- */
+/* д [E/TAG] ǰ׺ʽ[E/TAG]  [TAG] */
+static inline void log_put_tag(ulog_out_t *o, char level, const char *tag)
+{
+    if (tag && *tag) {
+        out_char(o, '[');
+        if (level) {
+            out_char(o, level);
+            out_char(o, '/');
+        }
+        while (*tag && o->len < o->size) {
+            o->buf[o->len++] = *tag++;
+        }
+        out_mem(o, "] ", 2);
+    }
+}
+
+/* д [E/TAG] ǰ׺ʱ */
+static inline void log_put_prefix(ulog_out_t *o, char level, const char *tag)
+{
+    log_put_tag(o, level, tag);
+	#if ULOG_WITH_TIMESTAMP
+    log_put_timestamp(o);
+    out_char(o, ' ');
+	#endif
+}
+
+/* ʱ "..." βʽĩβĻУд */
+static void log_finish(ulog_out_t *o, const char *fmt, size_t *pre_len)
+{
+    if (o->truncated && o->size >= 5) {
+        const char *end = fmt + strlen(fmt);
+        size_t nl = 0;
+        while (nl < 2 && end > fmt && (end[-1] == '\n' || end[-1] == '\r')) {
+            end--;
+            nl++;
+        }
+        /* ʱ len Ϊ sizeȫм¼ʱڵǰλ׷ */
+        if (o->len > o->size - 3 - nl) {
+            o->len = o->size - 3 - nl;
+        }
+        if (*pre_len > o->len) {
+            *pre_len = o->len;
+        }
+        out_mem(o, "...", 3);
+        out_mem(o, end, nl);
+    }
+    o->buf[o->len] = '\0';
+}
+
+/* αд [E/TAG] ǰ׺ʱģֵ size - 1
+ * *pre_len ǰ׺ʱĳȡ */
+static int format_log_message(char *buf, size_t size, size_t *pre_len,
+                                     char level, const char *tag,
+                                     const char *fmt, va_list args)
+{
+    ulog_out_t o = { buf, size - 1, 0, false };
+
+    log_put_prefix(&o, level, tag);
+    *pre_len = o.len;
+
+    /* ׷ʵ־ */
+    ulog_vformat(&o, fmt, args);
+    log_finish(&o, fmt, pre_len);
+
+    return (int)o.len;
+}
+
 /* -------------------------------------------------------------------------- */
-/* ڲ EasyLogger                                                */
+/* ˣɫ                                                       */
 /* -------------------------------------------------------------------------- */
-static void log_backend_easylogger(char level, const char *tag, const char *msg)
+/* ַ -> ֵ + 1 5 λ0 ʾ޼RAW */
+static const uint8_t ulog_level_map[32] = {
+    ['A' & 0x1F] = ULOG_LEVEL_ASSERT + 1,
+    ['E' & 0x1F] = ULOG_LEVEL_ERROR + 1,
+    ['W' & 0x1F] = ULOG_LEVEL_WARN + 1,
+    ['I' & 0x1F] = ULOG_LEVEL_INFO + 1,
+    ['D' & 0x1F] = ULOG_LEVEL_DEBUG + 1,
+    ['V' & 0x1F] = ULOG_LEVEL_VERBOSE + 1,
+};
+
+#define ULOG_SEG_LIT(s)     { s, sizeof(s) - 1 }
+
+#if ULOG_COLOR_ENABLE
+/*  ulog_level_map Ľ */
+static const ulog_seg_t ulog_color_seg[ULOG_LEVEL_VERBOSE + 2] = {
+    ULOG_SEG_LIT(""),
+    ULOG_SEG_LIT(ULOG_COLOR_ASSERT),
+    ULOG_SEG_LIT(ULOG_COLOR_ERROR),
+    ULOG_SEG_LIT(ULOG_COLOR_WARN),
+    ULOG_SEG_LIT(ULOG_COLOR_INFO),
+    ULOG_SEG_LIT(ULOG_COLOR_DEBUG),
+    ULOG_SEG_LIT(ULOG_COLOR_VERBOSE),
+};
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* úˣRTT                                                              */
+/* -------------------------------------------------------------------------- */
+#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_RTT)
+static void backend_rtt_init(ulog_backend_t *be)
+{
+    (void)be;
+    SEGGER_RTT_Init();
+}
+
+static void backend_rtt_write(ulog_backend_t *be, unsigned char terminal, char level,
+                              const char *tag, const ulog_seg_t *seg)
 {
+#if (SUPPORT_SEGGER_RTT == 1)
+    /* лն˺дͬһμɣ */
+    SEGGER_RTT_LOCK();
+    SEGGER_RTT_SetTerminal(terminal);
+    for (int i = 0; i < ULOG_SEG_COUNT; i++) {
+        if (seg[i].len) {
+            SEGGER_RTT_WriteNoLock(0, seg[i].ptr, (unsigned)seg[i].len);
+        }
+    }
+    SEGGER_RTT_UNLOCK();
+#else
+    (void)terminal;
+    (void)seg;
+#endif
+    (void)be;
+    (void)level;
+    (void)tag;
+}
+
+static ulog_backend_t ulog_backend_rtt = {
+    .name  = "rtt",
+    .level = ULOG_LEVEL_VERBOSE,
+    .flags = ULOG_BACKEND_COLOR,
+    .init  = backend_rtt_init,
+    .write = backend_rtt_write,
+};
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* úˣEasyLogger                                                       */
+/* -------------------------------------------------------------------------- */
 #if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_EASYLOGGER)
-    if (level) {
+static void backend_elog_init(ulog_backend_t *be)
+{
+    (void)be;
+    elog_init();
+    elog_start();
+}
+
+/* EasyLogger Դ𡢱ǩʱֻģ '\0' β */
+static void backend_elog_write(ulog_backend_t *be, unsigned char terminal, char level,
+                               const char *tag, const ulog_seg_t *seg)
+{
+    const char *msg = seg[ULOG_SEG_BODY].ptr;
+
+    (void)be;
+    (void)terminal;
+    /* ޱǩݣRAWHexdumpԭ */
+    if (level && tag && *tag) {
         switch (level) {
             case 'A': elog_assert(tag, "%s", msg); break;
             case 'E': elog_error(tag, "%s", msg); break;
@@ -119,73 +877,3455 @@ static void log_backend_easylogger(char level, const char *tag, const char *msg)
     } else {
         elog_raw("%s", msg);
     }
-#endif
 }
 
-/* -------------------------------------------------------------------------- */
-/* ڲ printf                                                    */
-/* -------------------------------------------------------------------------- */
-static void log_backend_printf(char level, const char *msg)
+static void backend_elog_flush(ulog_backend_t *be)
 {
-#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_PRINTF)
-  #if ULOG_COLOR_ENABLE
-    if (level) {
-        printf("%s%s%s", ULOG_GET_COLOR(level), msg, ULOG_COLOR_RESET);
-    } else {
-        printf("%s", msg);
-    }
-  #else
-    printf("%s", msg);
-  #endif
-#endif
+    (void)be;
+    elog_flush();
 }
 
-/* -------------------------------------------------------------------------- */
-/* ĺͳһ־                                                     */
-/* -------------------------------------------------------------------------- */
-void ulog_output_ex(unsigned char terminal_id,
-                                         char level, const char *tag,
-                                         const char *fmt, ...)
+static void backend_elog_deinit(ulog_backend_t *be)
 {
-#if !ULOG_OUTPUT_DISABLE
-    char buffer[ULOG_BUFFER_SIZE] = {0};
-    va_list args;
-    va_start(args, fmt);
-    int len = format_log_message(buffer, sizeof(buffer), level, tag, fmt, args);
-    va_end(args);
+    (void)be;
+    elog_stop();
+    elog_deinit();
+}
 
-    /* ͳһַ */
-    log_backend_rtt(terminal_id, level, buffer);
-    log_backend_easylogger(level, tag, buffer);
-    log_backend_printf(level, buffer);
+static ulog_backend_t ulog_backend_elog = {
+    .name   = "elog",
+    .level  = ULOG_LEVEL_VERBOSE,
+    .init   = backend_elog_init,
+    .write  = backend_elog_write,
+    .flush  = backend_elog_flush,
+    .deinit = backend_elog_deinit,
+};
 #endif
-}
 
 /* -------------------------------------------------------------------------- */
-/* Hexdump                                                            */
+/* úˣprintf                                                           */
 /* -------------------------------------------------------------------------- */
-void ulog_hexdump(const char *name, uint8_t width, const void *buf, uint16_t size)
+#if LOG_PRINTF_BUFFERED
+/* ģʽ¼ĸֱӿ뻺齻д
+ *   - д¼ֿд
+ *   - 𲻵 LOG_PRINTF_FLUSH_LEVEL
+ *   - ͣ LOG_PRINTF_FLUSH_MSPOSIX ɺ̨̼߳飬ƽ̨һ־ ulog_flush() ʱ飩
+ *   - ulog_flush() / ulog_deinit()
+ * ʹãд DMA ڼ䷵أ־дһ */
+#if ULOG_PORT_POSIX
+static void printf_write_default(const void *buf, size_t len)
 {
-#if !ULOG_OUTPUT_DISABLE
-    char line[128];
-
-    // ӡ
-    int len = snprintf(line, sizeof(line), "=== %s ===", name);
-    line[len] = '\0';
-    log_backend_rtt(ULOG_RTT_TERMINAL_ID, 0, line);
-    log_backend_easylogger(0, "", line);
-    log_backend_printf(0, line);
+    const char *p = (const char *)buf;
 
-    // ӡÿ
-    for (uint16_t i = 0; i < size; i += width) {
-        len = snprintf(line, sizeof(line), "%04X: ", i);
-        for (uint8_t j = 0; j < width && (i + j) < size; j++) {
-            len += snprintf(line + len, sizeof(line) - len, "%02X ", ((uint8_t*)buf)[i + j]);
+    while (len > 0) {
+        ssize_t n = write(STDOUT_FILENO, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
         }
-        line[len] = '\0';
-        log_backend_rtt(ULOG_RTT_TERMINAL_ID, 0, line);
-        log_backend_easylogger(0, "", line);
-        log_backend_printf(0, line);
+        p   += n;
+        len -= (size_t)n;
+    }
+}
+#else
+static void printf_write_default(const void *buf, size_t len)
+{
+    if (buf == NULL) {
+        fflush(stdout);
+        return;
     }
+    fwrite(buf, 1, len, stdout);
+}
+#endif
+
+static struct {
+#if ULOG_PORT_POSIX
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    pthread_t       thread;
+    bool            running;
+#endif
+    ulog_write_fn   write;
+    uint8_t         cur;            /* Ļ */
+    size_t          len;            /* ǰддֽ */
+#if LOG_PRINTF_FLUSH_MS
+    uint32_t        dirty_ms;       /* ǰһݵʱ */
+#endif
+    char            buf[2][LOG_PRINTF_BUFFER_SIZE];
+} ulog_printf = {
+#if ULOG_PORT_POSIX
+    .lock  = PTHREAD_MUTEX_INITIALIZER,
+    .cond  = PTHREAD_COND_INITIALIZER,
+#endif
+    .write = printf_write_default,
+};
+
+static inline void printf_lock(void)
+{
+#if ULOG_PORT_POSIX
+    pthread_mutex_lock(&ulog_printf.lock);
 #endif
-}
\ No newline at end of file
+}
+
+static inline void printf_unlock(void)
+{
+#if ULOG_PORT_POSIX
+    pthread_mutex_unlock(&ulog_printf.lock);
+#endif
+}
+
+void ulog_printf_set_write(ulog_write_fn fn)
+{
+    printf_lock();
+    if (ulog_printf.len) {
+        ulog_printf.write(ulog_printf.buf[ulog_printf.cur], ulog_printf.len);
+        ulog_printf.cur ^= 1u;
+        ulog_printf.len  = 0;
+    }
+    ulog_printf.write(NULL, 0);
+    ulog_printf.write = (fn != NULL) ? fn : printf_write_default;
+    printf_unlock();
+}
+#endif /* LOG_PRINTF_BUFFERED */
+
+#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_PRINTF)
+#if LOG_PRINTF_BUFFERED
+/* ߳ */
+static void printf_flush_locked(void)
+{
+    if (ulog_printf.len) {
+        ulog_printf.write(ulog_printf.buf[ulog_printf.cur], ulog_printf.len);
+        ulog_printf.cur ^= 1u;
+        ulog_printf.len  = 0;
+    }
+}
+
+static void backend_printf_write(ulog_backend_t *be, unsigned char terminal, char level,
+                                 const char *tag, const ulog_seg_t *seg)
+{
+    uint8_t lv = ulog_level_map[level & 0x1F];
+
+    (void)be;
+    (void)terminal;
+    (void)tag;
+    printf_lock();
+    for (int i = 0; i < ULOG_SEG_COUNT; i++) {
+        const char *p = seg[i].ptr;
+        size_t      n = seg[i].len;
+
+        while (n > 0) {
+            size_t room = LOG_PRINTF_BUFFER_SIZE - ulog_printf.len;
+            if (room == 0) {
+                printf_flush_locked();
+                room = LOG_PRINTF_BUFFER_SIZE;
+            }
+#if LOG_PRINTF_FLUSH_MS
+            if (ulog_printf.len == 0) {
+                ulog_printf.dirty_ms = ulog_get_timestamp();
+            }
+#endif
+            room = (n < room) ? n : room;
+            memcpy(ulog_printf.buf[ulog_printf.cur] + ulog_printf.len, p, room);
+            ulog_printf.len += room;
+            p += room;
+            n -= room;
+        }
+    }
+
+    /* RAW lv == 0ͼ */
+    if (lv != 0 && lv <= LOG_PRINTF_FLUSH_LEVEL + 1) {
+        printf_flush_locked();
+    }
+#if LOG_PRINTF_FLUSH_MS && !ULOG_PORT_POSIX
+    else if (ulog_printf.len && ulog_get_timestamp() - ulog_printf.dirty_ms >= LOG_PRINTF_FLUSH_MS) {
+        printf_flush_locked();
+    }
+#endif
+    printf_unlock();
+}
+
+static void backend_printf_flush(ulog_backend_t *be)
+{
+    (void)be;
+    printf_lock();
+    printf_flush_locked();
+    ulog_printf.write(NULL, 0);
+    printf_unlock();
+}
+
+#if ULOG_PORT_POSIX && LOG_PRINTF_FLUSH_MS
+/* ̨̣߳дͣõĻ */
+static void *printf_task(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&ulog_printf.lock);
+    while (ulog_printf.running) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += (long)(LOG_PRINTF_FLUSH_MS % 1000) * 1000000L;
+        ts.tv_sec  += LOG_PRINTF_FLUSH_MS / 1000 + ts.tv_nsec / 1000000000L;
+        ts.tv_nsec %= 1000000000L;
+        pthread_cond_timedwait(&ulog_printf.cond, &ulog_printf.lock, &ts);
+
+        if (ulog_printf.len && ulog_get_timestamp() - ulog_printf.dirty_ms >= LOG_PRINTF_FLUSH_MS) {
+            printf_flush_locked();
+        }
+    }
+    pthread_mutex_unlock(&ulog_printf.lock);
+    return NULL;
+}
+
+static void backend_printf_init(ulog_backend_t *be)
+{
+    (void)be;
+    pthread_mutex_lock(&ulog_printf.lock);
+    if (!ulog_printf.running) {
+        ulog_printf.running = true;
+        if (pthread_create(&ulog_printf.thread, NULL, printf_task, NULL) != 0) {
+            ulog_printf.running = false;
+        }
+    }
+    pthread_mutex_unlock(&ulog_printf.lock);
+}
+
+static void backend_printf_deinit(ulog_backend_t *be)
+{
+    bool joined;
+
+    (void)be;
+    pthread_mutex_lock(&ulog_printf.lock);
+    joined = ulog_printf.running;
+    ulog_printf.running = false;
+    pthread_cond_signal(&ulog_printf.cond);
+    pthread_mutex_unlock(&ulog_printf.lock);
+    if (joined) {
+        pthread_join(ulog_printf.thread, NULL);
+    }
+    backend_printf_flush(be);
+}
+#endif
+#else
+static void backend_printf_write(ulog_backend_t *be, unsigned char terminal, char level,
+                                 const char *tag, const ulog_seg_t *seg)
+{
+    (void)be;
+    (void)terminal;
+    (void)level;
+    (void)tag;
+#if ULOG_PORT_POSIX
+    flockfile(stdout);
+#endif
+    for (int i = 0; i < ULOG_SEG_COUNT; i++) {
+        if (seg[i].len) {
+            fwrite(seg[i].ptr, 1, seg[i].len, stdout);
+        }
+    }
+#if ULOG_PORT_POSIX
+    funlockfile(stdout);
+#endif
+}
+
+static void backend_printf_flush(ulog_backend_t *be)
+{
+    (void)be;
+    fflush(stdout);
+}
+#endif /* LOG_PRINTF_BUFFERED */
+
+static ulog_backend_t ulog_backend_printf = {
+    .name  = "printf",
+    .level = ULOG_LEVEL_VERBOSE,
+    .flags = ULOG_BACKEND_COLOR,
+#if LOG_PRINTF_BUFFERED && ULOG_PORT_POSIX && LOG_PRINTF_FLUSH_MS
+    .init   = backend_printf_init,
+    .deinit = backend_printf_deinit,
+#endif
+    .write = backend_printf_write,
+    .flush = backend_printf_flush,
+};
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* ע                                                                 */
+/* -------------------------------------------------------------------------- */
+/* ·ֻע/עӦڳʼ־ʱ */
+static ulog_backend_t *volatile ulog_backends[ULOG_MAX_BACKENDS] = {
+#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_RTT)
+    &ulog_backend_rtt,
+#endif
+#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_EASYLOGGER)
+    &ulog_backend_elog,
+#endif
+#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_PRINTF)
+    &ulog_backend_printf,
+#endif
+#if LOG_ENABLE_FILE
+    &ulog_backend_file,
+#endif
+#if LOG_ENABLE_NETWORK
+    &ulog_backend_syslog,
+#endif
+#if LOG_ENABLE_STORE
+    &ulog_backend_store,
+#endif
+#if LOG_ENABLE_SHM
+    &ulog_backend_shm,
+#endif
+};
+
+static volatile bool ulog_started;
+
+bool ulog_backend_register(ulog_backend_t *be)
+{
+    if (be == NULL || be->write == NULL || ulog_backend_find(be->name) != NULL) {
+        return false;
+    }
+    for (int i = 0; i < ULOG_MAX_BACKENDS; i++) {
+        if (ulog_backends[i] == NULL) {
+            /* ѳʼʱʼºˣɺŶ·ɼ */
+            if (ulog_started && be->init) {
+                be->init(be);
+            }
+            ulog_backends[i] = be;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ulog_backend_unregister(ulog_backend_t *be)
+{
+    for (int i = 0; i < ULOG_MAX_BACKENDS; i++) {
+        if (be != NULL && ulog_backends[i] == be) {
+            ulog_backends[i] = NULL;
+            if (be->flush) {
+                be->flush(be);
+            }
+            if (ulog_started && be->deinit) {
+                be->deinit(be);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+ulog_backend_t *ulog_backend_find(const char *name)
+{
+    for (int i = 0; i < ULOG_MAX_BACKENDS; i++) {
+        ulog_backend_t *be = ulog_backends[i];
+        if (be != NULL && name != NULL && be->name != NULL && strcmp(be->name, name) == 0) {
+            return be;
+        }
+    }
+    return NULL;
+}
+
+static void log_backends_init(void)
+{
+    for (int i = 0; i < ULOG_MAX_BACKENDS; i++) {
+        ulog_backend_t *be = ulog_backends[i];
+        if (be != NULL && be->init) {
+            be->init(be);
+        }
+    }
+    ulog_started = true;
+}
+
+static void log_backends_deinit(void)
+{
+    ulog_started = false;
+    for (int i = 0; i < ULOG_MAX_BACKENDS; i++) {
+        ulog_backend_t *be = ulog_backends[i];
+        if (be != NULL && be->flush) {
+            be->flush(be);
+        }
+        if (be != NULL && be->deinit) {
+            be->deinit(be);
+        }
+    }
+}
+
+/* ȴ첽е־ϣٳˢĻ */
+void ulog_flush(void)
+{
+#if LOG_ENABLE_FLIGHT
+    flight_pending_flush();
+#endif
+#if ULOG_USE_RING
+    log_ring_flush();   /* ظɷַȡ¼ */
+#elif ULOG_USE_DEDUP
+    dedup_report();
+#endif
+    for (int i = 0; i < ULOG_MAX_BACKENDS; i++) {
+        ulog_backend_t *be = ulog_backends[i];
+        if (be != NULL && be->flush) {
+            be->flush(be);
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* ڲַк                                                   */
+/* -------------------------------------------------------------------------- */
+/* msg ǰ pre_len ֽΪ [E/TAG] ǰ׺ʱΪģmsg[len] Ϊ '\0' */
+static void log_dispatch_out(unsigned char terminal, char level, const char *tag,
+                             const char *msg, size_t len, size_t pre_len)
+{
+    ulog_seg_t seg[ULOG_SEG_COUNT];
+    ulog_seg_t plain[ULOG_SEG_COUNT];
+    uint8_t lv = ulog_level_map[level & 0x1F];
+
+    plain[ULOG_SEG_COLOR]  = (ulog_seg_t)ULOG_SEG_LIT("");
+    plain[ULOG_SEG_PREFIX] = (ulog_seg_t){ msg, pre_len };
+    plain[ULOG_SEG_BODY]   = (ulog_seg_t){ msg + pre_len, len - pre_len };
+    plain[ULOG_SEG_RESET]  = (ulog_seg_t)ULOG_SEG_LIT("");
+    memcpy(seg, plain, sizeof(seg));
+#if ULOG_COLOR_ENABLE
+    if (level) {
+        seg[ULOG_SEG_COLOR] = ulog_color_seg[lv];
+        seg[ULOG_SEG_RESET] = (ulog_seg_t)ULOG_SEG_LIT(ULOG_COLOR_RESET);
+    }
+#endif
+    if (level && lv == 0) {
+        lv = ULOG_LEVEL_VERBOSE + 1;
+    }
+
+    for (int i = 0; i < ULOG_MAX_BACKENDS; i++) {
+        ulog_backend_t *be = ulog_backends[i];
+        if (be == NULL || (lv && lv - 1 > be->level)) {
+            continue;
+        }
+        be->write(be, terminal, level, tag, (be->flags & ULOG_BACKEND_COLOR) ? seg : plain);
+    }
+}
+
+#if ULOG_USE_DEDUP
+/* -------------------------------------------------------------------------- */
+/* ڲϲͬ־                                               */
+/* -------------------------------------------------------------------------- */
+/* ڷַȽϡύʱͬһʱֻһַߣûʱ߶ڷַ
+ *  ulog_dedup_lock ļ¼ϲճնˡǩĳͬ
+ * ģʱǰ LOG_DEDUP_COPY_SIZE ֽֽͬĵĹϣͬ
+ * ΪظֻйϣɱȣERROR/ASSERT ݴ˺ϲظһ
+ * ͬ־֮ǰظڼÿ LOG_DEDUP_REPORT_MS Լ ulog_flush() / ulog_deinit() ʱ
+ * ύʱַȡ¼ ulog_flush() 󣬾౾ּʼ
+ * LOG_DEDUP_REPORT_MS û¼¼ʱҲ */
+#define ULOG_DEDUP_TAG_MAX  32              /* ıǩϲ */
+
+static struct {
+    uint32_t      hash;
+    uint32_t      repeat;
+    uint32_t      since;                    /* ּʼʱ (ms) */
+    size_t        len;                      /* ĳ */
+    char          level;                    /* 0 ʾûпɱȽϵļ¼ */
+    unsigned char terminal;
+    char          tag[ULOG_DEDUP_TAG_MAX];
+    char          body[LOG_DEDUP_COPY_SIZE]; /* Ŀͷĸ */
+} ulog_dedup;
+
+#if ULOG_USE_RING
+#define dedup_lock()        true
+#define dedup_unlock()      ((void)0)
+#else
+static atomic_flag ulog_dedup_lock = ATOMIC_FLAG_INIT;
+#define dedup_lock()        (!atomic_flag_test_and_set_explicit(&ulog_dedup_lock, memory_order_acquire))
+#define dedup_unlock()      atomic_flag_clear_explicit(&ulog_dedup_lock, memory_order_release)
+#endif
+
+static int dedup_format(char *buf, size_t size, size_t *pre_len, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int len = format_log_message(buf, size, pre_len, ulog_dedup.level, ulog_dedup.tag, fmt, args);
+    va_end(args);
+    return len;
+}
+
+static void dedup_flush(void)
+{
+    char buf[96];
+    size_t pre_len;
+
+    if (ulog_dedup.repeat == 0) {
+        return;
+    }
+    int len = dedup_format(buf, sizeof(buf), &pre_len, "last message repeated %lu times\r\n",
+                           (unsigned long)ulog_dedup.repeat);
+    ulog_dedup.repeat = 0;
+    log_dispatch_out(ulog_dedup.terminal, ulog_dedup.level, ulog_dedup.tag, buf, (size_t)len, pre_len);
+}
+
+/*  true ʾһͬѼ */
+static bool dedup_check(unsigned char terminal, char level, const char *tag,
+                        const char *body, size_t len)
+{
+    uint32_t h = 2166136261u;
+    size_t tag_len = (tag != NULL) ? strlen(tag) : 0;
+    size_t copy = (len < LOG_DEDUP_COPY_SIZE) ? len : LOG_DEDUP_COPY_SIZE;
+
+    /* İ 4 ֽһۼӣ˷ֽڶ */
+    const char *p = body;
+    size_t n = len;
+    for (; n >= 4; n -= 4, p += 4) {
+        uint32_t w;
+        memcpy(&w, p, 4);
+        h = (h ^ w) * 16777619u;
+        h ^= h >> 15;
+    }
+    while (n--) {
+        h = (h ^ (uint8_t)*p++) * 16777619u;
+    }
+
+    if (ulog_dedup.level == level && ulog_dedup.terminal == terminal && ulog_dedup.len == len &&
+        ulog_dedup.hash == h && tag_len < ULOG_DEDUP_TAG_MAX &&
+        memcmp(ulog_dedup.tag, (tag != NULL) ? tag : "", tag_len + 1) == 0 &&
+        memcmp(ulog_dedup.body, body, copy) == 0 &&
+        (len == copy || (level != 'E' && level != 'A'))) {
+        uint32_t now = ulog_get_timestamp();
+        if (ulog_dedup.repeat++ == 0) {
+            ulog_dedup.since = now;
+        } else if (now - ulog_dedup.since >= LOG_DEDUP_REPORT_MS) {
+            dedup_flush();
+        }
+        return true;
+    }
+
+    dedup_flush();
+    ulog_dedup.hash     = h;
+    ulog_dedup.len      = len;
+    ulog_dedup.level    = level;
+    ulog_dedup.terminal = terminal;
+    /* ıǩֻضϱ棨Ƚʱκμ¼ͬ */
+    strncpy(ulog_dedup.tag, (tag != NULL) ? tag : "", sizeof(ulog_dedup.tag) - 1);
+    memcpy(ulog_dedup.body, body, copy);
+    return false;
+}
+
+/* ulog_flush() / ulog_deinit() δظ */
+static void dedup_report(void)
+{
+    if (dedup_lock()) {
+        dedup_flush();
+        dedup_unlock();
+    }
+}
+
+#if ULOG_USE_RING
+/* ַȡ¼ã󣬻ظѳ LOG_DEDUP_REPORT_MS û¼¼ */
+static void dedup_idle(bool requested)
+{
+    if (ulog_dedup.repeat != 0 &&
+        (requested || ulog_get_timestamp() - ulog_dedup.since >= LOG_DEDUP_REPORT_MS)) {
+        dedup_flush();
+    }
+}
+#endif
+#endif /* ULOG_USE_DEDUP */
+
+static void log_dispatch(unsigned char terminal, char level, const char *tag,
+                         const char *msg, size_t len, size_t pre_len)
+{
+#if ULOG_USE_DEDUP
+    /* ԭʼ޼𣩲ϲ */
+    if (level && dedup_lock()) {
+        bool dup = dedup_check(terminal, level, tag, msg + pre_len, len - pre_len);
+        dedup_unlock();
+        if (dup) {
+            return;
+        }
+    }
+#endif
+    log_dispatch_out(terminal, level, tag, msg, len, pre_len);
+}
+
+/* -------------------------------------------------------------------------- */
+/* ʱ                                                       */
+/* -------------------------------------------------------------------------- */
+#if LOG_ENABLE_RUNTIME_LEVEL_CONTROL || LOG_ENABLE_FILTER
+/* ǩÿֹıǩǼһΣֻ׷Ӳɾ
+ * Ȱֱַַӳ仺棨ʱ O(1)δֱٰ */
+typedef struct {
+    atomic_bool      valid;
+    volatile uint8_t level;         /* ULOG_LEVEL_INHERIT ʾȫּ */
+    volatile uint8_t blocked;       /* ǩ */
+    char             name[LOG_TAG_NAME_MAX];
+} ulog_tag_t;
+
+typedef struct {
+    const void *_Atomic  key;       /* ǩַַ */
+    ulog_tag_t *_Atomic  tag;
+    atomic_uint          hash;      /* ǩɢУں˶ԱʱδǼǵıǩ */
+} ulog_tag_cache_t;
+
+#if (LOG_TAG_CACHE_SIZE & (LOG_TAG_CACHE_SIZE - 1))
+#error "LOG_TAG_CACHE_SIZE must be a power of two"
+#endif
+
+static ulog_tag_t       ulog_tags[LOG_MAX_RUNTIME_TAGS];
+static atomic_uint      ulog_tag_count;
+static ulog_tag_cache_t ulog_tag_cache[LOG_TAG_CACHE_SIZE];
+static ulog_tag_t       ulog_tag_untracked;     /* бʾ"δǼ"ֻȽϵַ */
+static volatile uint8_t ulog_tag_rules;     /* ڵǩʱ 0 */
+#endif
+
+#if LOG_ENABLE_RUNTIME_LEVEL_CONTROL
+static volatile uint8_t ulog_runtime_level = ULOG_STATIC_LEVEL;
+#define ULOG_GLOBAL_LEVEL   ulog_runtime_level
+#else
+#define ULOG_GLOBAL_LEVEL   ULOG_STATIC_LEVEL
+#endif
+
+#if LOG_ENABLE_FILTER
+static char             ulog_filter_tags[LOG_MAX_FILTER_TAGS][LOG_TAG_NAME_MAX];
+static volatile uint8_t ulog_filter_tag_count;
+static char             ulog_filter_keywords[LOG_MAX_FILTER_KEYWORDS][LOG_FILTER_KEYWORD_LEN];
+static volatile uint8_t ulog_filter_keyword_count;
+
+static bool filter_tag_blocked(const char *name)
+{
+    uint8_t n = ulog_filter_tag_count;
+
+    for (uint8_t i = 0; i < n; i++) {
+        if (strstr(name, ulog_filter_tags[i]) != NULL) {
+            return false;
+        }
+    }
+    return n != 0;
+}
+
+/* ؼʹˣֻͨжϲʽִ֮ */
+static bool filter_keyword_pass(const char *msg)
+{
+    uint8_t n = ulog_filter_keyword_count;
+
+    for (uint8_t i = 0; i < n; i++) {
+        if (strstr(msg, ulog_filter_keywords[i]) != NULL) {
+            return true;
+        }
+    }
+    return n == 0;
+}
+#endif
+
+#if LOG_ENABLE_RUNTIME_LEVEL_CONTROL || LOG_ENABLE_FILTER
+static ulog_tag_t *tag_find(const char *name)
+{
+    unsigned n = atomic_load_explicit(&ulog_tag_count, memory_order_acquire);
+
+    if (n > LOG_MAX_RUNTIME_TAGS) {
+        n = LOG_MAX_RUNTIME_TAGS;
+    }
+    for (unsigned i = 0; i < n; i++) {
+        ulog_tag_t *t = &ulog_tags[i];
+        if (atomic_load_explicit(&t->valid, memory_order_acquire) &&
+            strncmp(t->name, name, LOG_TAG_NAME_MAX - 1) == 0) {
+            return t;
+        }
+    }
+    return NULL;
+}
+
+/* һǼǱǩʱ NULL */
+static ulog_tag_t *tag_intern(const char *name)
+{
+    ulog_tag_t *t = tag_find(name);
+    if (t != NULL) {
+        return t;
+    }
+
+    /* ⶥڱҲͲƸб */
+    unsigned idx = atomic_load_explicit(&ulog_tag_count, memory_order_relaxed);
+    do {
+        if (idx >= LOG_MAX_RUNTIME_TAGS) {
+            return tag_find(name);      /* һܸպñ̵߳Ǽǳͬ */
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&ulog_tag_count, &idx, idx + 1,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    t = &ulog_tags[idx];
+    strncpy(t->name, name, LOG_TAG_NAME_MAX - 1);
+    t->name[LOG_TAG_NAME_MAX - 1] = '\0';
+    t->level = ULOG_LEVEL_INHERIT;
+#if LOG_ENABLE_FILTER
+    t->blocked = filter_tag_blocked(t->name);
+#endif
+    atomic_store_explicit(&t->valid, true, memory_order_release);
+    return t;
+}
+
+static uint32_t tag_hash(const char *name)
+{
+    uint32_t h = 2166136261u;
+
+    for (unsigned i = 0; i < LOG_TAG_NAME_MAX - 1 && name[i] != '\0'; i++) {
+        h = (h ^ (uint8_t)name[i]) * 16777619u;
+    }
+    return h;
+}
+
+/* key Ϊõ㴫ַַname Ϊǩ
+ * _TAG ӿڿܸͬһ黺ͬıǩַкҪ˶֣δд */
+static ulog_tag_t *tag_lookup(const void *key, const char *name)
+{
+    uintptr_t h = (uintptr_t)key;
+    ulog_tag_cache_t *c = &ulog_tag_cache[((h >> 2) ^ (h >> 9)) & (LOG_TAG_CACHE_SIZE - 1)];
+
+    /*  tag ǰȷһ key滻Ļ */
+    if (atomic_load_explicit(&c->key, memory_order_acquire) == key) {
+        ulog_tag_t *t = atomic_load_explicit(&c->tag, memory_order_acquire);
+        uint32_t hash = atomic_load_explicit(&c->hash, memory_order_acquire);
+        if (atomic_load_explicit(&c->key, memory_order_acquire) == key) {
+            if (t == &ulog_tag_untracked) {
+                if (hash == tag_hash(name)) {
+                    return NULL;
+                }
+            } else if (strncmp(t->name, name, LOG_TAG_NAME_MAX - 1) == 0) {
+                return t;
+            }
+        }
+    }
+
+    /* ʱδǼǵıǩҲ֮ͬһõ㲻ٱű */
+    ulog_tag_t *t = tag_intern(name);
+    atomic_store_explicit(&c->key, NULL, memory_order_release);
+    atomic_store_explicit(&c->tag, (t != NULL) ? t : &ulog_tag_untracked, memory_order_release);
+    atomic_store_explicit(&c->hash, (t != NULL) ? 0 : tag_hash(name), memory_order_release);
+    atomic_store_explicit(&c->key, key, memory_order_release);
+    return t;
+}
+#endif
+
+/* ʽ֮ǰļ/ǩж */
+static bool log_gate(char level, const void *key, const char *tag)
+{
+    uint8_t lv = ulog_level_map[level & 0x1F];
+
+    if (level == 0) {
+        return true;            /* RAW ܼ */
+    }
+    if (lv == 0) {
+        lv = ULOG_LEVEL_VERBOSE + 1;
+    }
+#if LOG_ENABLE_RUNTIME_LEVEL_CONTROL || LOG_ENABLE_FILTER
+    if (ulog_tag_rules && tag != NULL && *tag) {
+        uint8_t limit = ULOG_GLOBAL_LEVEL;
+        ulog_tag_t *t = tag_lookup(key, tag);
+        if (t != NULL) {
+            if (t->blocked) {
+                return false;
+            }
+            if (t->level != ULOG_LEVEL_INHERIT) {
+                limit = t->level;
+            }
+        }
+        return lv - 1 <= limit;
+    }
+#endif
+    (void)key;
+    (void)tag;
+    return lv - 1 <= ULOG_GLOBAL_LEVEL;
+}
+
+bool ulog_is_enabled(char level, const char *tag)
+{
+#if ULOG_OUTPUT_DISABLE
+    (void)level;
+    (void)tag;
+    return false;
+#else
+    return log_gate(level, tag, tag);
+#endif
+}
+
+#if LOG_ENABLE_RUNTIME_LEVEL_CONTROL
+/* -------------------------------------------------------------------------- */
+/* ʱ/ȡ                                                        */
+/* -------------------------------------------------------------------------- */
+/* ʱֵܳüĵ޷ָ */
+void ulog_set_level(uint8_t level)
+{
+    ulog_runtime_level = (level > ULOG_STATIC_LEVEL) ? ULOG_STATIC_LEVEL : level;
+}
+
+uint8_t ulog_get_level(void)
+{
+    return ulog_runtime_level;
+}
+
+bool ulog_set_tag_level(const char *tag, uint8_t level)
+{
+    ulog_tag_t *t = tag_intern(tag);
+    if (t == NULL) {
+        return false;
+    }
+    /* ͬǩ򲢷Ǽǳֶȫ */
+    for (unsigned i = 0; i < LOG_MAX_RUNTIME_TAGS; i++) {
+        if (atomic_load_explicit(&ulog_tags[i].valid, memory_order_acquire) &&
+            strncmp(ulog_tags[i].name, t->name, LOG_TAG_NAME_MAX - 1) == 0) {
+            ulog_tags[i].level = level;
+        }
+    }
+    ulog_tag_rules = 1;
+    return true;
+}
+
+uint8_t ulog_get_tag_level(const char *tag)
+{
+    ulog_tag_t *t = tag_find(tag);
+    return (t != NULL && t->level != ULOG_LEVEL_INHERIT) ? t->level : ulog_runtime_level;
+}
+#endif
+
+#if LOG_ENABLE_FILTER
+/* -------------------------------------------------------------------------- */
+/* ǩ/ؼʹ                                                        */
+/* -------------------------------------------------------------------------- */
+static void filter_tags_apply(void)
+{
+    unsigned n = atomic_load_explicit(&ulog_tag_count, memory_order_acquire);
+
+    if (n > LOG_MAX_RUNTIME_TAGS) {
+        n = LOG_MAX_RUNTIME_TAGS;
+    }
+    for (unsigned i = 0; i < n; i++) {
+        if (atomic_load_explicit(&ulog_tags[i].valid, memory_order_acquire)) {
+            ulog_tags[i].blocked = filter_tag_blocked(ulog_tags[i].name);
+        }
+    }
+    ulog_tag_rules = 1;
+}
+
+bool ulog_filter_add_tag(const char *tag)
+{
+    uint8_t n = ulog_filter_tag_count;
+
+    if (n >= LOG_MAX_FILTER_TAGS) {
+        return false;
+    }
+    strncpy(ulog_filter_tags[n], tag, LOG_TAG_NAME_MAX - 1);
+    ulog_filter_tags[n][LOG_TAG_NAME_MAX - 1] = '\0';
+    ulog_filter_tag_count = n + 1;
+    filter_tags_apply();
+    return true;
+}
+
+bool ulog_filter_add_keyword(const char *keyword)
+{
+    uint8_t n = ulog_filter_keyword_count;
+
+    if (n >= LOG_MAX_FILTER_KEYWORDS) {
+        return false;
+    }
+    strncpy(ulog_filter_keywords[n], keyword, LOG_FILTER_KEYWORD_LEN - 1);
+    ulog_filter_keywords[n][LOG_FILTER_KEYWORD_LEN - 1] = '\0';
+    ulog_filter_keyword_count = n + 1;
+    return true;
+}
+
+void ulog_filter_clear(void)
+{
+    ulog_filter_tag_count = 0;
+    ulog_filter_keyword_count = 0;
+    filter_tags_apply();
+}
+#endif
+
+#if ULOG_USE_RING
+/* -------------------------------------------------------------------------- */
+/* ύλ                                         */
+/* -------------------------------------------------------------------------- */
+/* ɹ̶СĵԪɣһ¼ռɵԪÿԪš
+ *  CAS ƽ head ԤԪдݺ󷢲׵Ԫţ CAS ƽ
+ * tail ȡ߼¼黹ԪDROP_OLDEST ҲΪ
+ * ɵļ¼Գͬʹ CAS
+ * 첽ģʽɺ̨ȡ¼ͬģʽȨĵȡ */
+#if LOG_ENABLE_ASYNC
+#define ULOG_RING_SIZE      LOG_ASYNC_BUFFER_SIZE
+#define ULOG_RING_CELL      LOG_ASYNC_CELL_SIZE
+#else
+#define ULOG_RING_SIZE      LOG_COMMIT_BUFFER_SIZE
+#define ULOG_RING_CELL      LOG_COMMIT_CELL_SIZE
+#endif
+#define ULOG_RING_CELLS     (ULOG_RING_SIZE / ULOG_RING_CELL)
+#define ULOG_RING_MASK      (ULOG_RING_CELLS - 1)
+#define ULOG_RING_TAG_MAX   31
+
+#if (ULOG_RING_CELLS < 2) || (ULOG_RING_CELLS & ULOG_RING_MASK)
+#error "ring buffer size / cell size must be a power of two"
+#endif
+
+typedef struct {
+    atomic_size_t seq;
+    atomic_uint   ncell;        /* ׵ԪЧ¼ռõĵԪ */
+    uint8_t       data[ULOG_RING_CELL];
+} ulog_cell_t;
+
+typedef struct {
+    uint16_t len;               /* Ϣ */
+    uint16_t pre_len;           /* Ϣǰ׺ĳ */
+    uint8_t  tag_len;           /* ǩȣǩڼ¼ͷ֮ */
+    uint8_t  terminal;
+    char     level;
+} ulog_rec_hdr_t;
+
+static struct {
+    ulog_cell_t   cell[ULOG_RING_CELLS];
+    atomic_size_t head;         /* Ԥλ */
+    atomic_size_t tail;         /* ߶ȡλ */
+    atomic_bool   running;
+    atomic_uint   busy;         /* д */
+    atomic_uint   written;
+    atomic_uint   dispatched;   /* ѽ˵ļ¼ */
+    atomic_uint   dropped;
+    atomic_uint   overwritten;
+    atomic_uint   dropped_error;
+#ifdef LOG_THREAD_ID
+    const void *_Atomic drainer;    /* ڰѼ¼˵߳ */
+#endif
+#if ULOG_USE_DEDUP
+    atomic_bool   dedup_req;    /* ulog_flush() ظ */
+#endif
+#if !LOG_ENABLE_ASYNC
+    atomic_flag   owner;        /* ͬģʽȨ */
+#endif
+} ulog_ring = {
+#if !LOG_ENABLE_ASYNC
+    .owner = ATOMIC_FLAG_INIT,
+#endif
+};
+
+#if ULOG_USE_DEDUP
+#define ring_dedup_pending()    atomic_load_explicit(&ulog_ring.dedup_req, memory_order_acquire)
+#else
+#define ring_dedup_pending()    false
+#endif
+
+static void log_ring_wake(bool isr);
+static void log_ring_yield(void);
+#if !LOG_ENABLE_ASYNC
+static void log_ring_wait(unsigned waits);
+#endif
+static void log_dispatch_fmt(char level, const char *tag, const char *fmt, ...);
+
+static void ring_copy_in(size_t pos, size_t off, const void *src, size_t n)
+{
+    const uint8_t *p = (const uint8_t *)src;
+
+    while (n) {
+        ulog_cell_t *c = &ulog_ring.cell[(pos + off / ULOG_RING_CELL) & ULOG_RING_MASK];
+        size_t o = off % ULOG_RING_CELL;
+        size_t chunk = ULOG_RING_CELL - o;
+        if (chunk > n) {
+            chunk = n;
+        }
+        memcpy(c->data + o, p, chunk);
+        p   += chunk;
+        off += chunk;
+        n   -= chunk;
+    }
+}
+
+static void ring_copy_out(size_t pos, size_t off, void *dst, size_t n)
+{
+    uint8_t *p = (uint8_t *)dst;
+
+    while (n) {
+        const ulog_cell_t *c = &ulog_ring.cell[(pos + off / ULOG_RING_CELL) & ULOG_RING_MASK];
+        size_t o = off % ULOG_RING_CELL;
+        size_t chunk = ULOG_RING_CELL - o;
+        if (chunk > n) {
+            chunk = n;
+        }
+        memcpy(p, c->data + o, chunk);
+        p   += chunk;
+        off += chunk;
+        n   -= chunk;
+    }
+}
+
+/* Ԥ k Ԫ false
+ * tries ƾʧܺԴжʹã0 ʾޡ */
+static bool ring_reserve(size_t k, size_t *out, unsigned tries)
+{
+    size_t pos = atomic_load_explicit(&ulog_ring.head, memory_order_relaxed);
+
+    for (;;) {
+        size_t i;
+        intptr_t dif = 0;
+
+        for (i = 0; i < k; i++) {
+            size_t seq = atomic_load_explicit(&ulog_ring.cell[(pos + i) & ULOG_RING_MASK].seq,
+                                              memory_order_acquire);
+            dif = (intptr_t)(seq - (pos + i));
+            if (dif != 0) {
+                break;
+            }
+        }
+
+        if (i == k) {
+            if (atomic_compare_exchange_weak_explicit(&ulog_ring.head, &pos, pos + k,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                *out = pos;
+                return true;
+            }
+        } else if (dif < 0) {
+            /* ԪԱһȦļ¼ռãhead δ仯˵ȷʵ */
+            size_t cur = atomic_load_explicit(&ulog_ring.head, memory_order_relaxed);
+            if (cur == pos) {
+                return false;
+            }
+            pos = cur;
+        } else {
+            pos = atomic_load_explicit(&ulog_ring.head, memory_order_relaxed);
+        }
+        if (tries && --tries == 0) {
+            return false;
+        }
+    }
+}
+
+/* ȡɵһѷ¼շ falsetries ͬ ring_reserve */
+static bool ring_pop(size_t *out, unsigned *k, unsigned tries)
+{
+    size_t pos = atomic_load_explicit(&ulog_ring.tail, memory_order_relaxed);
+
+    for (;;) {
+        ulog_cell_t *c = &ulog_ring.cell[pos & ULOG_RING_MASK];
+        size_t seq = atomic_load_explicit(&c->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t)(seq - (pos + 1));
+
+        if (dif == 0) {
+            unsigned n = atomic_load_explicit(&c->ncell, memory_order_relaxed);
+            if (atomic_compare_exchange_weak_explicit(&ulog_ring.tail, &pos, pos + n,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                *out = pos;
+                *k   = n;
+                return true;
+            }
+        } else if (dif < 0) {
+            return false;
+        } else {
+            pos = atomic_load_explicit(&ulog_ring.tail, memory_order_relaxed);
+        }
+        if (tries && --tries == 0) {
+            return false;
+        }
+    }
+}
+
+static void ring_release(size_t pos, unsigned k)
+{
+    for (unsigned i = 0; i < k; i++) {
+        atomic_store_explicit(&ulog_ring.cell[(pos + i) & ULOG_RING_MASK].seq,
+                              pos + i + ULOG_RING_CELLS, memory_order_release);
+    }
+}
+
+/* дһѸʽļ¼δʱ falseɵֱ
+ * isr Ϊ true ʱ ULOG_IN_ISR() ȴԴޡ */
+static bool log_ring_push(unsigned char terminal, char level, const char *tag,
+                          const char *msg, size_t len, size_t pre_len, bool isr)
+{
+    ulog_rec_hdr_t hdr;
+    size_t tag_len = (tag != NULL) ? strlen(tag) : 0;
+    size_t pos;
+#if LOG_ENABLE_ASYNC
+    int policy = LOG_ASYNC_OVERFLOW;
+#else
+    int policy = ULOG_ASYNC_BLOCK;      /* ͬģʽʱԼڳռ */
+#endif
+    bool urgent = (level == 'A' || level == 'E');
+
+    atomic_fetch_add_explicit(&ulog_ring.busy, 1, memory_order_acquire);
+    if (!atomic_load_explicit(&ulog_ring.running, memory_order_acquire)) {
+        atomic_fetch_sub_explicit(&ulog_ring.busy, 1, memory_order_release);
+        return false;
+    }
+
+    isr = isr || ULOG_IN_ISR();
+    if (tag_len > ULOG_RING_TAG_MAX) {
+        tag_len = ULOG_RING_TAG_MAX;
+    }
+    if (len > ULOG_RING_SIZE - sizeof(hdr) - tag_len) {
+        len = ULOG_RING_SIZE - sizeof(hdr) - tag_len;
+    }
+    size_t k = (sizeof(hdr) + tag_len + len + ULOG_RING_CELL - 1) / ULOG_RING_CELL;
+    unsigned tries = isr ? LOG_ISR_RESERVE_TRIES : 0;
+    unsigned rounds = 0;
+#if !LOG_ENABLE_ASYNC
+    unsigned waits = 0;
+#endif
+
+    /* ͶԲеȴжиΪɼ¼ */
+    if (urgent) {
+        policy = isr ? ULOG_ASYNC_DROP_OLDEST : ULOG_ASYNC_BLOCK;
+    } else if (policy == ULOG_ASYNC_BLOCK && isr) {
+        policy = ULOG_ASYNC_DROP_NEWEST;
+    }
+
+    while (!ring_reserve(k, &pos, tries)) {
+        if (policy == ULOG_ASYNC_BLOCK &&
+            atomic_load_explicit(&ulog_ring.running, memory_order_relaxed)) {
+#ifdef LOG_THREAD_ID
+            /* ־ֻɱ߳ڳȥ */
+            if (atomic_load_explicit(&ulog_ring.drainer, memory_order_relaxed) == LOG_THREAD_ID()) {
+                policy = ULOG_ASYNC_DROP_NEWEST;
+                continue;
+            }
+#endif
+#if !LOG_ENABLE_ASYNC
+            /* ռſռĿǵòеĵȼRTOS  SCHED_FIFO µȼת
+             * ȴޣ󰴶 */
+            if (++waits > LOG_COMMIT_WAIT_TRIES) {
+                policy = ULOG_ASYNC_DROP_NEWEST;
+                continue;
+            }
+            log_ring_wake(isr);
+            log_ring_wait(waits);
+#else
+            log_ring_wake(isr);
+            log_ring_yield();
+#endif
+            continue;
+        }
+        if (policy == ULOG_ASYNC_DROP_OLDEST && !(isr && ++rounds >= LOG_ISR_RESERVE_TRIES)) {
+            size_t old;
+            unsigned n;
+            if (ring_pop(&old, &n, tries)) {
+                ring_release(old, n);
+                atomic_fetch_add_explicit(&ulog_ring.overwritten, 1, memory_order_relaxed);
+                continue;
+            }
+        }
+        atomic_fetch_add_explicit(urgent ? &ulog_ring.dropped_error : &ulog_ring.dropped,
+                                  1, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&ulog_ring.busy, 1, memory_order_release);
+        log_ring_wake(isr);
+        return true;
+    }
+
+    hdr.len      = (uint16_t)len;
+    hdr.pre_len  = (uint16_t)((pre_len < len) ? pre_len : len);
+    hdr.tag_len  = (uint8_t)tag_len;
+    hdr.terminal = terminal;
+    hdr.level    = level;
+    ring_copy_in(pos, 0, &hdr, sizeof(hdr));
+    ring_copy_in(pos, sizeof(hdr), tag, tag_len);
+    ring_copy_in(pos, sizeof(hdr) + tag_len, msg, len);
+
+    /* дٷ׵Ԫ */
+    atomic_store_explicit(&ulog_ring.cell[pos & ULOG_RING_MASK].ncell, (unsigned)k, memory_order_relaxed);
+    atomic_store_explicit(&ulog_ring.cell[pos & ULOG_RING_MASK].seq, pos + 1, memory_order_release);
+    atomic_fetch_add_explicit(&ulog_ring.written, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&ulog_ring.busy, 1, memory_order_release);
+
+    log_ring_wake(isr);
+    return true;
+}
+
+/* ȡм¼ˣͬһʱֻһִߣ̨Ȩߣ */
+static void log_ring_drain(void)
+{
+    static char msg[ULOG_BUFFER_SIZE];
+    static uint32_t reported;
+    char tag[ULOG_RING_TAG_MAX + 1];
+    ulog_rec_hdr_t hdr;
+    size_t pos;
+    unsigned k;
+
+#ifdef LOG_THREAD_ID
+    atomic_store_explicit(&ulog_ring.drainer, LOG_THREAD_ID(), memory_order_relaxed);
+#endif
+    while (ring_pop(&pos, &k, 0)) {
+        ring_copy_out(pos, 0, &hdr, sizeof(hdr));
+        if (hdr.len >= sizeof(msg)) {
+            hdr.len = sizeof(msg) - 1;
+        }
+        ring_copy_out(pos, sizeof(hdr), tag, hdr.tag_len);
+        ring_copy_out(pos, sizeof(hdr) + hdr.tag_len, msg, hdr.len);
+        ring_release(pos, k);
+
+        tag[hdr.tag_len] = '\0';
+        msg[hdr.len]     = '\0';
+        if (hdr.pre_len > hdr.len) {
+            hdr.pre_len = hdr.len;
+        }
+        log_dispatch(hdr.terminal, hdr.level, tag, msg, hdr.len, hdr.pre_len);
+        atomic_fetch_add_explicit(&ulog_ring.dispatched, 1, memory_order_release);
+    }
+
+#if ULOG_USE_DEDUP
+    dedup_idle(atomic_exchange_explicit(&ulog_ring.dedup_req, false, memory_order_acq_rel));
+#endif
+
+    /* ļ¼Ϣһ */
+    uint32_t lost = atomic_load_explicit(&ulog_ring.dropped, memory_order_relaxed)
+                  + atomic_load_explicit(&ulog_ring.overwritten, memory_order_relaxed)
+                  + atomic_load_explicit(&ulog_ring.dropped_error, memory_order_relaxed);
+    if (lost != reported) {
+        log_dispatch_fmt('W', "ULOG", "%lu records dropped\r\n", (unsigned long)(lost - reported));
+        reported = lost;
+    }
+#ifdef LOG_THREAD_ID
+    atomic_store_explicit(&ulog_ring.drainer, NULL, memory_order_relaxed);
+#endif
+}
+
+#if LOG_ENABLE_ASYNC
+/* -------------------------------------------------------------------------- */
+/* 첽ģʽ̨                                                     */
+/* -------------------------------------------------------------------------- */
+#if ULOG_PORT_POSIX
+static pthread_t ulog_async_thread;
+static sem_t     ulog_async_sem;
+
+static void log_ring_wake(bool isr)
+{
+    (void)isr;
+    sem_post(&ulog_async_sem);
+}
+
+static void log_ring_yield(void)
+{
+    sched_yield();
+}
+
+static void *ulog_async_task(void *arg)
+{
+    (void)arg;
+    while (atomic_load_explicit(&ulog_ring.running, memory_order_acquire)) {
+#if ULOG_USE_DEDUP
+        /* ʱû¼¼ʱظҲ */
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec  += LOG_DEDUP_REPORT_MS / 1000;
+        ts.tv_nsec += (LOG_DEDUP_REPORT_MS % 1000) * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        sem_timedwait(&ulog_async_sem, &ts);
+#else
+        sem_wait(&ulog_async_sem);
+#endif
+        log_ring_drain();
+    }
+    return NULL;
+}
+#else
+#define ULOG_ASYNC_FLAG     0x01U
+
+static osThreadId_t ulog_async_thread;
+static atomic_bool  ulog_async_exited;
+
+static void log_ring_wake(bool isr)
+{
+    (void)isr;
+    if (ulog_async_thread != NULL) {
+        osThreadFlagsSet(ulog_async_thread, ULOG_ASYNC_FLAG);
+    }
+}
+
+static void log_ring_yield(void)
+{
+    osDelay(1);     /* ó CPUȼ */
+}
+
+static void ulog_async_task(void *arg)
+{
+    (void)arg;
+    while (atomic_load_explicit(&ulog_ring.running, memory_order_acquire)) {
+#if ULOG_USE_DEDUP
+        /* ʱû¼¼ʱظҲ */
+        osThreadFlagsWait(ULOG_ASYNC_FLAG, osFlagsWaitAny,
+                          (uint32_t)((uint64_t)LOG_DEDUP_REPORT_MS * osKernelGetTickFreq() / 1000u));
+#else
+        osThreadFlagsWait(ULOG_ASYNC_FLAG, osFlagsWaitAny, osWaitForever);
+#endif
+        log_ring_drain();
+    }
+    atomic_store_explicit(&ulog_async_exited, true, memory_order_release);
+    osThreadExit();
+}
+#endif
+
+#else
+/* -------------------------------------------------------------------------- */
+/* ͬģʽ˭Ȩ˭                                               */
+/* -------------------------------------------------------------------------- */
+/* ɵļ¼ѷȡ */
+static bool ring_pending(void)
+{
+    size_t pos = atomic_load_explicit(&ulog_ring.tail, memory_order_relaxed);
+    return atomic_load_explicit(&ulog_ring.cell[pos & ULOG_RING_MASK].seq,
+                                memory_order_acquire) == pos + 1;
+}
+
+/* Ȩĵ߰ѻύļ¼жύģ
+ * ˣ˲ᱻá˵ͷȨ
+ * ټһλ¼¼ύ˳һδд
+ * ¼֮ļ¼¼ύ */
+static void log_ring_combine(void)
+{
+    for (;;) {
+        /* һ"¼ -> Ȩ"˳ԣ˫һԷд */
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!(ring_pending() || ring_dedup_pending()) ||
+            atomic_flag_test_and_set_explicit(&ulog_ring.owner, memory_order_acquire)) {
+            return;
+        }
+        log_ring_drain();
+        atomic_flag_clear_explicit(&ulog_ring.owner, memory_order_release);
+    }
+}
+
+/* жֻύ¼һĵ־ ulog_flush() */
+static void log_ring_wake(bool isr)
+{
+    if (!isr) {
+        log_ring_combine();
+    }
+}
+
+static void log_ring_yield(void)
+{
+#if ULOG_PORT_POSIX
+    sched_yield();
+#else
+    LOG_THREAD_YIELD();
+#endif
+}
+
+/* ʱȴڳռ䡣POSIX  sched_yield()֮ÿ˯ 1 ms
+ * LOG_COMMIT_WAIT_TRIES εܵȴʱ RTOS  osDelay(1) ൱ */
+static void log_ring_wait(unsigned waits)
+{
+#if ULOG_PORT_POSIX
+    if (waits > 16) {
+        struct timespec ts = { 0, 1000000L };
+        nanosleep(&ts, NULL);
+        return;
+    }
+#else
+    (void)waits;
+#endif
+    log_ring_yield();
+}
+#endif /* LOG_ENABLE_ASYNC */
+
+static void log_ring_start(void)
+{
+    if (atomic_load(&ulog_ring.running)) {
+        return;
+    }
+    for (size_t i = 0; i < ULOG_RING_CELLS; i++) {
+        atomic_init(&ulog_ring.cell[i].seq, i);
+        atomic_init(&ulog_ring.cell[i].ncell, 0);
+    }
+    atomic_init(&ulog_ring.head, 0);
+    atomic_init(&ulog_ring.tail, 0);
+    atomic_store(&ulog_ring.running, true);
+
+#if LOG_ENABLE_ASYNC && ULOG_PORT_POSIX
+    sem_init(&ulog_async_sem, 0, 0);
+    if (pthread_create(&ulog_async_thread, NULL, ulog_async_task, NULL) != 0) {
+        atomic_store(&ulog_ring.running, false);
+        sem_destroy(&ulog_async_sem);
+    }
+#elif LOG_ENABLE_ASYNC
+    const osThreadAttr_t attr = {
+        .name       = "ulog",
+        .stack_size = LOG_ASYNC_TASK_STACK,
+        .priority   = LOG_ASYNC_TASK_PRIORITY,
+    };
+    atomic_store(&ulog_async_exited, false);
+    ulog_async_thread = osThreadNew(ulog_async_task, NULL, &attr);
+    if (ulog_async_thread == NULL) {
+        atomic_store(&ulog_ring.running, false);
+    }
+#endif
+}
+
+static void log_ring_stop(void)
+{
+    if (!atomic_load(&ulog_ring.running)) {
+        return;
+    }
+    /* ֹͣ¼¼ȴд */
+    atomic_store(&ulog_ring.running, false);
+    while (atomic_load(&ulog_ring.busy) != 0) {
+        log_ring_yield();
+    }
+
+#if LOG_ENABLE_ASYNC && ULOG_PORT_POSIX
+    sem_post(&ulog_async_sem);
+    pthread_join(ulog_async_thread, NULL);
+    sem_destroy(&ulog_async_sem);
+#elif LOG_ENABLE_ASYNC
+    log_ring_wake(false);
+    while (!atomic_load(&ulog_async_exited)) {
+        osDelay(1);
+    }
+    ulog_async_thread = NULL;
+#else
+    /* ȵǰɣʣ¼Լ */
+    while (atomic_flag_test_and_set_explicit(&ulog_ring.owner, memory_order_acquire)) {
+        log_ring_yield();
+    }
+#endif
+
+    log_ring_drain();
+#if !LOG_ENABLE_ASYNC
+    atomic_flag_clear_explicit(&ulog_ring.owner, memory_order_release);
+#endif
+}
+
+/* ȴǰдļ¼ȫˣжл򻺳δʱֱӷ */
+static void log_ring_flush(void)
+{
+    uint32_t target = atomic_load_explicit(&ulog_ring.written, memory_order_acquire);
+
+    if (ULOG_IN_ISR()) {
+        return;
+    }
+#if ULOG_USE_DEDUP
+    atomic_store_explicit(&ulog_ring.dedup_req, true, memory_order_release);
+#endif
+#ifdef LOG_THREAD_ID
+    /* еãľԼȲʣ¼ڱд */
+    if (atomic_load_explicit(&ulog_ring.drainer, memory_order_relaxed) == LOG_THREAD_ID()) {
+        return;
+    }
+#endif
+    /* дļ¼꣬ҷַѴظ */
+    while (atomic_load_explicit(&ulog_ring.running, memory_order_acquire) &&
+           ((uint32_t)(atomic_load_explicit(&ulog_ring.dispatched, memory_order_acquire) +
+                       atomic_load_explicit(&ulog_ring.overwritten, memory_order_relaxed) -
+                       target) > 0x7FFFFFFFu || ring_dedup_pending())) {
+        log_ring_wake(false);
+        log_ring_yield();
+    }
+}
+
+/* ڲʹãʽֱˣύ */
+static void log_dispatch_fmt(char level, const char *tag, const char *fmt, ...)
+{
+    char buffer[128];
+    size_t pre_len;
+    va_list args;
+    va_start(args, fmt);
+    int len = format_log_message(buffer, sizeof(buffer), &pre_len, level, tag, fmt, args);
+    va_end(args);
+    log_dispatch(ULOG_RTT_TERMINAL_ID, level, tag, buffer, (size_t)len, pre_len);
+}
+
+/* -------------------------------------------------------------------------- */
+/* ȡύͳ                                                         */
+/* -------------------------------------------------------------------------- */
+void ulog_async_get_stats(ulog_async_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    stats->written       = atomic_load_explicit(&ulog_ring.written, memory_order_relaxed);
+    stats->dropped       = atomic_load_explicit(&ulog_ring.dropped, memory_order_relaxed);
+    stats->overwritten   = atomic_load_explicit(&ulog_ring.overwritten, memory_order_relaxed);
+    stats->dropped_error = atomic_load_explicit(&ulog_ring.dropped_error, memory_order_relaxed);
+}
+#endif /* ULOG_USE_RING */
+
+/* -------------------------------------------------------------------------- */
+/* ڲύһѸʽļ¼                                           */
+/* -------------------------------------------------------------------------- */
+static void log_commit(unsigned char terminal, char level, const char *tag,
+                       const char *msg, size_t len, size_t pre_len, bool isr)
+{
+#if LOG_ENABLE_CRASH_LOG
+    /* ύ֮ǰ£ʱδ־Ҳܱ */
+    ulog_crash_record(msg, len);
+#endif
+#if ULOG_USE_RING
+    /* ¼ύɺ̨ǰ߽ */
+    if (log_ring_push(terminal, level, tag, msg, len, pre_len, isr)) {
+        return;
+    }
+    /* δУulog_init() ֮ǰ ulog_deinit() ֮󣩣жвúˣ */
+    if (isr || ULOG_IN_ISR()) {
+        bool urgent = (level == 'A' || level == 'E');
+        atomic_fetch_add_explicit(urgent ? &ulog_ring.dropped_error : &ulog_ring.dropped,
+                                  1, memory_order_relaxed);
+        return;
+    }
+#endif
+    (void)isr;
+
+    /* ͳһַ */
+    log_dispatch(terminal, level, tag, msg, len, pre_len);
+}
+
+#if LOG_ENABLE_STATS || LOG_ENABLE_FLIGHT
+/* ־ϵͳʾУжϺͳƣͨ־һύ */
+static void log_commit_fmt(char level, const char *tag, const char *fmt, ...)
+{
+    char buffer[160];
+    size_t pre_len;
+    va_list args;
+    va_start(args, fmt);
+    int len = format_log_message(buffer, sizeof(buffer), &pre_len, level, tag, fmt, args);
+    va_end(args);
+    log_commit(ULOG_RTT_TERMINAL_ID, level, tag, buffer, (size_t)len, pre_len, false);
+}
+#endif
+
+#if LOG_ENABLE_RECORD_POOL
+/* -------------------------------------------------------------------------- */
+/* ¼أ                                                       */
+/* -------------------------------------------------------------------------- */
+/* head 8 λΪ ۺ + 10 ʾؿգ8~15 λΪв 16 λΪ汾ţ
+ * ÿ޸ļ 1ֹ ABAnext[] ͬ ۺ + 1
+ * ulog_init() ֮ǰΪգеöջ */
+#if (LOG_POOL_SLOTS < 1) || (LOG_POOL_SLOTS > 254)
+#error "LOG_POOL_SLOTS must be 1..254"
+#endif
+
+#define POOL_HEAD(h, idx, nfree)    ((((h) + 0x10000u) & 0xFFFF0000u) | ((unsigned)(nfree) << 8) | (idx))
+
+static struct {
+    char        slot[LOG_POOL_SLOTS][LOG_POOL_SLOT_SIZE];
+    atomic_uint next[LOG_POOL_SLOTS];
+    atomic_uint head;
+    atomic_bool ready;
+    atomic_uint peak;
+    atomic_uint fallback;
+} ulog_pool;
+
+static void pool_put(char *buf)
+{
+    unsigned i = (unsigned)((buf - ulog_pool.slot[0]) / LOG_POOL_SLOT_SIZE);
+    unsigned h = atomic_load_explicit(&ulog_pool.head, memory_order_relaxed);
+
+    do {
+        atomic_store_explicit(&ulog_pool.next[i], h & 0xFFu, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&ulog_pool.head, &h,
+                                                    POOL_HEAD(h, i + 1, ((h >> 8) & 0xFFu) + 1),
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+/* ȡһۣؿʱ NULL */
+static char *pool_get(void)
+{
+    unsigned h = atomic_load_explicit(&ulog_pool.head, memory_order_acquire);
+    unsigned i, next, nfree;
+
+    do {
+        i = h & 0xFFu;
+        if (i == 0) {
+            atomic_fetch_add_explicit(&ulog_pool.fallback, 1, memory_order_relaxed);
+            return NULL;
+        }
+        next  = atomic_load_explicit(&ulog_pool.next[i - 1], memory_order_relaxed);
+        nfree = ((h >> 8) & 0xFFu) - 1;
+    } while (!atomic_compare_exchange_weak_explicit(&ulog_pool.head, &h, POOL_HEAD(h, next, nfree),
+                                                    memory_order_acquire, memory_order_acquire));
+
+    /* ֵٱ仯ֻͨһζ */
+    unsigned used = LOG_POOL_SLOTS - nfree;
+    unsigned p = atomic_load_explicit(&ulog_pool.peak, memory_order_relaxed);
+    while (used > p && !atomic_compare_exchange_weak_explicit(&ulog_pool.peak, &p, used,
+                                                              memory_order_relaxed, memory_order_relaxed)) {
+    }
+    return ulog_pool.slot[i - 1];
+}
+
+static void pool_init(void)
+{
+    if (atomic_exchange(&ulog_pool.ready, true)) {
+        return;
+    }
+    for (unsigned i = 0; i < LOG_POOL_SLOTS; i++) {
+        pool_put(ulog_pool.slot[i]);
+    }
+}
+
+void ulog_pool_get_stats(ulog_pool_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    stats->fallback = atomic_load_explicit(&ulog_pool.fallback, memory_order_relaxed);
+    stats->peak     = atomic_load_explicit(&ulog_pool.peak, memory_order_relaxed);
+}
+#endif /* LOG_ENABLE_RECORD_POOL */
+
+#if LOG_ENABLE_STATS
+/* -------------------------------------------------------------------------- */
+/* ־ͳƣǩ͵õ                                               */
+/* -------------------------------------------------------------------------- */
+/* ǩֵĹϣѰַ CAS Ǽǡֻɾıǩ "*"
+ * õɺ꾲̬䣬״ξʱ relaxed ԭۼӣ
+ * ·ϲȡʱ֮䲻֤ͬһʱ̵Ŀա */
+#if (LOG_STATS_TAGS & (LOG_STATS_TAGS - 1))
+#error "LOG_STATS_TAGS must be a power of two"
+#endif
+
+#ifdef LOG_STATS_CYCLES
+#define stats_cycles()      ((uint32_t)LOG_STATS_CYCLES())
+#elif ULOG_PORT_POSIX
+static uint32_t stats_cycles(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)ts.tv_sec * 1000000000u + (uint32_t)ts.tv_nsec;
+}
+#elif ULOG_USE_CLOCK && (ULOG_TS_SOURCE == ULOG_TS_SOURCE_DWT)
+#define stats_cycles()      (DWT->CYCCNT)
+#else
+#define stats_cycles()      0u
+#endif
+
+#define STATS_TAG_MAX       16
+#define STATS_AT(s, field)  ((_Atomic uint32_t *)&(s)->field)
+#define STATS_ADD(s, field, v) \
+    atomic_fetch_add_explicit(STATS_AT(s, field), (uint32_t)(v), memory_order_relaxed)
+#define STATS_GET(s, field, reset) \
+    ((reset) ? atomic_exchange_explicit(STATS_AT(s, field), 0, memory_order_relaxed) \
+             : atomic_load_explicit(STATS_AT(s, field), memory_order_relaxed))
+
+typedef struct {
+    atomic_uint  hash;              /* 0 ʾ */
+    atomic_bool  named;             /* name д */
+    char         name[STATS_TAG_MAX];
+    ulog_stats_t stats;
+} ulog_stats_tag_t;
+
+static ulog_stats_tag_t      ulog_stats_tags[LOG_STATS_TAGS];
+static ulog_stats_t          ulog_stats_other;
+static ulog_site_t *_Atomic  ulog_stats_sites;
+#if LOG_STATS_DUMP_MS
+static atomic_uint           ulog_stats_last;   /* ϴԶܵʱ (ms) */
+#endif
+
+/* ұǩļcreate Ϊ true ʱǼ±ǩʱ "*" */
+static ulog_stats_t *stats_tag(const char *tag, bool create)
+{
+    uint32_t h = 2166136261u;
+
+    if (tag == NULL) {
+        tag = "";
+    }
+    for (const char *p = tag; *p; p++) {
+        h = (h ^ (uint8_t)*p) * 16777619u;
+    }
+    if (h == 0) {
+        h = 1;
+    }
+
+    for (unsigned i = 0; i < LOG_STATS_TAGS; i++) {
+        ulog_stats_tag_t *t = &ulog_stats_tags[(h + i) & (LOG_STATS_TAGS - 1)];
+        unsigned cur = atomic_load_explicit(&t->hash, memory_order_acquire);
+
+        if (cur == 0) {
+            if (!create) {
+                return NULL;
+            }
+            if (atomic_compare_exchange_strong_explicit(&t->hash, &cur, h, memory_order_acq_rel,
+                                                        memory_order_acquire)) {
+                strncpy(t->name, tag, sizeof(t->name) - 1);
+                atomic_store_explicit(&t->named, true, memory_order_release);
+                return &t->stats;
+            }
+        }
+        /* Ǽдڼ䣬ͬѾԼ */
+        if (cur == h) {
+            return &t->stats;
+        }
+    }
+    return create ? &ulog_stats_other : NULL;
+}
+
+static void stats_site_link(ulog_site_t *site, char level, const char *tag)
+{
+    if (atomic_exchange_explicit((_Atomic uint8_t *)&site->linked, 1, memory_order_relaxed)) {
+        return;
+    }
+    site->level = level;
+    site->tag   = tag;
+
+    ulog_site_t *head = atomic_load_explicit(&ulog_stats_sites, memory_order_relaxed);
+    do {
+        site->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&ulog_stats_sites, &head, site,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+static void stats_add(ulog_stats_t *s, size_t bytes, uint32_t fmt_cycles, uint32_t out_cycles)
+{
+    STATS_ADD(s, emitted, 1);
+    STATS_ADD(s, bytes, bytes);
+    STATS_ADD(s, fmt_cycles, fmt_cycles);
+    STATS_ADD(s, out_cycles, out_cycles);
+}
+
+/* һ־ύsite Ϊ NULLжڡṹ־ûеõϢ· */
+static void stats_emitted(ulog_site_t *site, char level, const char *tag, size_t bytes,
+                          uint32_t fmt_cycles, uint32_t out_cycles)
+{
+    stats_add(stats_tag(tag, true), bytes, fmt_cycles, out_cycles);
+    if (site != NULL) {
+        stats_site_link(site, level, tag);
+        stats_add(&site->stats, bytes, fmt_cycles, out_cycles);
+    }
+}
+
+void ulog_stats_suppress(ulog_site_t *site, char level, const char *tag)
+{
+    STATS_ADD(stats_tag(tag, true), suppressed, 1);
+    if (site != NULL) {
+        stats_site_link(site, level, tag);
+        STATS_ADD(&site->stats, suppressed, 1);
+    }
+}
+
+static void stats_read(ulog_stats_t *s, ulog_stats_t *out, bool reset)
+{
+    out->emitted    = STATS_GET(s, emitted, reset);
+    out->suppressed = STATS_GET(s, suppressed, reset);
+    out->bytes      = STATS_GET(s, bytes, reset);
+    out->fmt_cycles = STATS_GET(s, fmt_cycles, reset);
+    out->out_cycles = STATS_GET(s, out_cycles, reset);
+}
+
+bool ulog_stats_get_tag(const char *tag, ulog_stats_t *stats)
+{
+    ulog_stats_t *s = stats_tag(tag, false);
+
+    if (s == NULL || stats == NULL) {
+        return false;
+    }
+    stats_read(s, stats, false);
+    return true;
+}
+
+static void stats_walk(void (*fn)(const ulog_stats_entry_t *e, void *user), void *user, bool reset)
+{
+    ulog_stats_entry_t e;
+
+    memset(&e, 0, sizeof(e));
+    for (unsigned i = 0; i < LOG_STATS_TAGS; i++) {
+        ulog_stats_tag_t *t = &ulog_stats_tags[i];
+        if (!atomic_load_explicit(&t->named, memory_order_acquire)) {
+            continue;
+        }
+        e.tag = t->name;
+        stats_read(&t->stats, &e.stats, reset);
+        fn(&e, user);
+    }
+    e.tag = "*";
+    stats_read(&ulog_stats_other, &e.stats, reset);
+    if (e.stats.emitted || e.stats.suppressed) {
+        fn(&e, user);
+    }
+
+    for (ulog_site_t *s = atomic_load_explicit(&ulog_stats_sites, memory_order_acquire);
+         s != NULL; s = s->next) {
+        e.tag   = (s->tag != NULL) ? s->tag : "";
+        e.file  = s->file;
+        e.line  = s->line;
+        e.level = s->level;
+        stats_read(&s->stats, &e.stats, reset);
+        fn(&e, user);
+    }
+}
+
+void ulog_stats_foreach(void (*fn)(const ulog_stats_entry_t *e, void *user), void *user)
+{
+    if (fn != NULL) {
+        stats_walk(fn, user, false);
+    }
+}
+
+static void stats_nop(const ulog_stats_entry_t *e, void *user)
+{
+    (void)e;
+    (void)user;
+}
+
+void ulog_stats_reset(void)
+{
+    stats_walk(stats_nop, NULL, true);
+}
+
+static void stats_dump_entry(const ulog_stats_entry_t *e, void *user)
+{
+    const ulog_stats_t *s = &e->stats;
+
+    (void)user;
+    if (s->emitted == 0 && s->suppressed == 0) {
+        return;
+    }
+    if (e->file == NULL) {
+        log_commit_fmt('I', "ULOG", "stats tag=%s emitted=%lu suppressed=%lu bytes=%lu fmt=%lu out=%lu\r\n",
+                       e->tag, (unsigned long)s->emitted, (unsigned long)s->suppressed,
+                       (unsigned long)s->bytes, (unsigned long)s->fmt_cycles, (unsigned long)s->out_cycles);
+        return;
+    }
+
+    const char *file = e->file;
+    for (const char *p = file; *p; p++) {
+        if (*p == '/' || *p == '\\') {
+            file = p + 1;
+        }
+    }
+    log_commit_fmt('I', "ULOG", "stats site=%s:%lu level=%c tag=%s emitted=%lu suppressed=%lu bytes=%lu "
+                   "fmt=%lu out=%lu\r\n",
+                   file, (unsigned long)e->line, e->level ? e->level : '-', e->tag,
+                   (unsigned long)s->emitted, (unsigned long)s->suppressed, (unsigned long)s->bytes,
+                   (unsigned long)s->fmt_cycles, (unsigned long)s->out_cycles);
+}
+
+/* ֻмıreset Ϊ true ʱÿ㣬֮ */
+void ulog_stats_dump(bool reset)
+{
+    stats_walk(stats_dump_entry, NULL, reset);
+}
+
+#if LOG_STATS_DUMP_MS
+static void stats_init(void)
+{
+    atomic_store_explicit(&ulog_stats_last, ulog_get_timestamp(), memory_order_relaxed);
+}
+
+/* е־ͬһֻһ */
+static void stats_poll(void)
+{
+    uint32_t now  = ulog_get_timestamp();
+    unsigned last = atomic_load_explicit(&ulog_stats_last, memory_order_relaxed);
+
+    if (now - last >= LOG_STATS_DUMP_MS &&
+        atomic_compare_exchange_strong_explicit(&ulog_stats_last, &last, now,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        ulog_stats_dump(true);
+    }
+}
+#endif
+#endif /* LOG_ENABLE_STATS */
+
+#if LOG_ENABLE_METRIC
+/* -------------------------------------------------------------------------- */
+/* ָۺϣƵֻۼƣ                                   */
+/* -------------------------------------------------------------------------- */
+/* ָɺ꾲̬䣬״θʱۼӺֱͼ relaxed ԭۼӣ
+ * С/ֵ CAS £ʱ㣬ֶ֮䲻֤ͬһʱ̵Ŀա
+ * о ulog_output_ex ָļͱǩ */
+#if (LOG_METRIC_BUCKETS < 1)
+#error "LOG_METRIC_BUCKETS must be at least 1"
+#endif
+
+#define METRIC_AT(m, field)     ((_Atomic uint32_t *)&(m)->field)
+#define METRIC_I32(m, field)    ((_Atomic int32_t *)&(m)->field)
+#define METRIC_HIST_TEXT        (LOG_METRIC_BUCKETS * 11 + 32)
+
+static ulog_metric_t *_Atomic ulog_metrics;
+#if LOG_METRIC_PERIOD_MS
+static atomic_uint            ulog_metric_last; /* ϴܵʱ (ms) */
+static void metric_poll(void);
+#endif
+
+static void metric_link(ulog_metric_t *m, unsigned char terminal_id, char level, const char *tag)
+{
+    if (atomic_exchange_explicit((_Atomic uint8_t *)&m->linked, 1, memory_order_relaxed)) {
+        return;
+    }
+    m->terminal = terminal_id;
+    m->level    = level;
+    m->tag      = (tag != NULL) ? tag : "";
+
+    ulog_metric_t *head = atomic_load_explicit(&ulog_metrics, memory_order_relaxed);
+    do {
+        m->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&ulog_metrics, &head, m,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+void ulog_metric_update(ulog_metric_t *m, unsigned char terminal_id, char level, const char *tag,
+                        int32_t value)
+{
+    if (!atomic_load_explicit((_Atomic uint8_t *)&m->linked, memory_order_relaxed)) {
+        metric_link(m, terminal_id, level, tag);
+    }
+
+    atomic_fetch_add_explicit(METRIC_AT(m, count), 1u, memory_order_relaxed);
+    atomic_fetch_add_explicit((_Atomic ulog_metric_sum_t *)&m->sum, (ulog_metric_sum_t)value,
+                              memory_order_relaxed);
+
+    int32_t cur = atomic_load_explicit(METRIC_I32(m, min), memory_order_relaxed);
+    while (value < cur && !atomic_compare_exchange_weak_explicit(METRIC_I32(m, min), &cur, value,
+                                                                 memory_order_relaxed, memory_order_relaxed)) {
+    }
+    cur = atomic_load_explicit(METRIC_I32(m, max), memory_order_relaxed);
+    while (value > cur && !atomic_compare_exchange_weak_explicit(METRIC_I32(m, max), &cur, value,
+                                                                 memory_order_relaxed, memory_order_relaxed)) {
+    }
+
+    if (m->width) {
+        uint32_t b = 0;
+        if (value >= m->hi) {
+            b = LOG_METRIC_BUCKETS - 1;
+        } else if (value > m->lo) {
+            b = (uint32_t)((uint32_t)value - (uint32_t)m->lo) / m->width;
+        }
+        atomic_fetch_add_explicit(METRIC_AT(m, hist[b]), 1u, memory_order_relaxed);
+    }
+
+#if LOG_METRIC_PERIOD_MS
+    metric_poll();
+#endif
+}
+
+/* ָֻꣻֱͼͰԶŷָ lo ÿͰ width */
+void ulog_metric_dump(void)
+{
+    for (ulog_metric_t *m = atomic_load_explicit(&ulog_metrics, memory_order_acquire);
+         m != NULL; m = m->next) {
+        uint32_t n = atomic_exchange_explicit(METRIC_AT(m, count), 0u, memory_order_relaxed);
+        if (n == 0) {
+            continue;
+        }
+        int32_t mn = atomic_exchange_explicit(METRIC_I32(m, min), INT32_MAX, memory_order_relaxed);
+        int32_t mx = atomic_exchange_explicit(METRIC_I32(m, max), INT32_MIN, memory_order_relaxed);
+        ulog_metric_sum_t sum = atomic_exchange_explicit((_Atomic ulog_metric_sum_t *)&m->sum, 0,
+                                                         memory_order_relaxed);
+
+        char hist[METRIC_HIST_TEXT];
+        size_t k = 0;
+        hist[0] = '\0';
+        if (m->width) {
+            k = (size_t)snprintf(hist, sizeof(hist), " hist[%ld,%ld)=", (long)m->lo, (long)m->hi);
+            for (int i = 0; i < LOG_METRIC_BUCKETS && k < sizeof(hist); i++) {
+                uint32_t c = atomic_exchange_explicit(METRIC_AT(m, hist[i]), 0u, memory_order_relaxed);
+                k += (size_t)snprintf(hist + k, sizeof(hist) - k, i ? ",%lu" : "%lu", (unsigned long)c);
+            }
+        }
+        ulog_output_ex(m->terminal, m->level, m->tag, "metric %s n=%lu min=%ld max=%ld mean=%ld%s\r\n",
+                       m->name, (unsigned long)n, (long)mn, (long)mx, (long)(sum / (ulog_metric_sum_t)n), hist);
+    }
+}
+
+#if LOG_METRIC_PERIOD_MS
+static void metric_init(void)
+{
+    atomic_store_explicit(&ulog_metric_last, ulog_get_timestamp(), memory_order_relaxed);
+}
+
+/* ָºе־ͬһֻһܣжв */
+static void metric_poll(void)
+{
+    uint32_t now  = ulog_get_timestamp();
+    unsigned last = atomic_load_explicit(&ulog_metric_last, memory_order_relaxed);
+
+    if (now - last >= LOG_METRIC_PERIOD_MS && !ULOG_IN_ISR() &&
+        atomic_compare_exchange_strong_explicit(&ulog_metric_last, &last, now,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        ulog_metric_dump();
+    }
+}
+#endif
+#endif /* LOG_ENABLE_METRIC */
+
+#if LOG_ENABLE_FLIGHT
+/* -------------------------------------------------------------------------- */
+/* м¼ϸ־ֻʷʱ                                   */
+/* -------------------------------------------------------------------------- */
+/*  LOG_FLIGHT_LEVEL ־ʽֻѸʽַǩʱԭʼ
+ *  LOG_FLIGHT_SLOTS ۣתɵģERROR/ASSERT 
+ * ulog_output_ex  ulog_flight_flush() ʱδʷԭ˳ʽ
+ * ύˡ
+ * ÿ۴ţдΪ 2*n+1дΪ 2*n+2д CAS ռòۣȴ
+ * ߰ź˶ԣٺ˶һΣǻδдļ¼Ϊʧ
+ * ַУʽַֻΪַ */
+#if (LOG_FLIGHT_SLOTS & (LOG_FLIGHT_SLOTS - 1))
+#error "LOG_FLIGHT_SLOTS must be a power of two"
+#endif
+#if (LOG_FLIGHT_DATA_SIZE > 255)
+#error "LOG_FLIGHT_DATA_SIZE must be <= 255"
+#endif
+
+typedef struct {
+    const char   *fmt;
+#if ULOG_WITH_TIMESTAMP
+    uint32_t      sec;
+    uint32_t      usec;
+#endif
+    char          level;
+    unsigned char terminal;
+    uint8_t       tag_len;
+    uint8_t       len;                      /* data бǩ + ֽ */
+    bool          trunc;                    /* ûдȫ */
+    uint8_t       data[LOG_FLIGHT_DATA_SIZE];
+} ulog_flight_rec_t;
+
+typedef struct {
+    atomic_uint       seq;
+    ulog_flight_rec_t rec;
+} ulog_flight_slot_t;
+
+static struct {
+    ulog_flight_slot_t slot[LOG_FLIGHT_SLOTS];
+    atomic_uint        head;                /* һ¼ı */
+    unsigned           read;                /* һıţֻɳ busy ޸ */
+    atomic_bool        busy;
+    atomic_bool        pending;             /* жг ERRORȴ */
+    atomic_uint        flushed;
+    atomic_uint        lost;
+} ulog_flight;
+
+static uint8_t *flight_put(uint8_t *p, const uint8_t *end, const void *v, size_t n)
+{
+    if (p == NULL || n > (size_t)(end - p)) {
+        return NULL;
+    }
+    memcpy(p, v, n);
+    return p + n;
+}
+
+/*  ulog_vformat ĹȡԭУ治ʱһĽβ */
+static uint8_t *flight_pack(uint8_t *p, const uint8_t *end, const char *f, va_list args, bool *trunc)
+{
+    uint8_t *done = p;
+
+    while (p != NULL && *f) {
+        if (*f++ != '%') {
+            continue;
+        }
+        if (*f == '%') {
+            f++;
+            continue;
+        }
+        done = p;
+        while (*f == '-' || *f == '+' || *f == ' ' || *f == '#' || *f == '0') {
+            f++;
+        }
+        if (*f == '*') {
+            int w = va_arg(args, int);
+            p = flight_put(p, end, &w, sizeof(w));
+            f++;
+        }
+        while (*f >= '0' && *f <= '9') {
+            f++;
+        }
+        if (*f == '.') {
+            f++;
+            if (*f == '*') {
+                int pr = va_arg(args, int);
+                p = flight_put(p, end, &pr, sizeof(pr));
+                f++;
+            }
+            while (*f >= '0' && *f <= '9') {
+                f++;
+            }
+        }
+
+        char lm = 0;
+        switch (*f) {
+            case 'h': f++; if (*f == 'h') f++; break;
+            case 'l': lm = 'l'; f++; if (*f == 'l') { lm = 'q'; f++; } break;
+            case 'j': lm = 'q'; f++; break;
+            case 'z': case 't': lm = 'z'; f++; break;
+            case 'L': lm = 'L'; f++; break;
+            default : break;
+        }
+        if (lm == 'l' && *f == 'c') {
+            lm = 'w';       /* %lc Ĳ wint_t */
+        }
+
+        switch (*f++) {
+            case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+                if (lm == 'q') {
+                    long long v = va_arg(args, long long);
+                    p = flight_put(p, end, &v, sizeof(v));
+                } else if (lm == 'w') {
+                    wint_t v = va_arg(args, wint_t);
+                    p = flight_put(p, end, &v, sizeof(v));
+                } else if (lm == 'l') {
+                    long v = va_arg(args, long);
+                    p = flight_put(p, end, &v, sizeof(v));
+                } else if (lm == 'z') {
+                    intptr_t v = va_arg(args, intptr_t);
+                    p = flight_put(p, end, &v, sizeof(v));
+                } else {
+                    int v = va_arg(args, int);
+                    p = flight_put(p, end, &v, sizeof(v));
+                }
+                break;
+            case 'p': {
+                void *v = va_arg(args, void *);
+                p = flight_put(p, end, &v, sizeof(v));
+                break;
+            }
+            case 'f': case 'F': case 'e': case 'E':
+            case 'g': case 'G': case 'a': case 'A': {
+                double d = (lm == 'L') ? (double)va_arg(args, long double) : va_arg(args, double);
+                p = flight_put(p, end, &d, sizeof(d));
+                break;
+            }
+            case 's': {
+                if (lm == 'l') {
+                    const wchar_t *ws = va_arg(args, const wchar_t *);
+                    if (p == NULL || p == end) {
+                        p = NULL;
+                        break;
+                    }
+                    size_t n = wcs_to_mb((char *)p + 1, (size_t)(end - p) - 1, ws, trunc);
+                    if (*trunc) {
+                        /* ĩβŲ°ַֽʱ 0 βطʱ %s  0  */
+                        memset(p + 1 + n, 0, (size_t)(end - p) - 1 - n);
+                        n = (size_t)(end - p) - 1;
+                    }
+                    *p = (uint8_t)n;
+                    p += 1 + n;
+                    if (*trunc) {
+                        return p;
+                    }
+                    break;
+                }
+                const char *s = va_arg(args, const char *);
+                size_t n = (s != NULL) ? strlen(s) : 0;
+                uint8_t n8;
+                /* ַŲʱضϵʣռ䣬ٱĲ */
+                if (p != NULL && n + 1 > (size_t)(end - p)) {
+                    n = (end - p > 1) ? (size_t)(end - p) - 1 : 0;
+                    *trunc = true;
+                }
+                n8 = (uint8_t)n;
+                p = flight_put(p, end, &n8, 1);
+                p = flight_put(p, end, s, n);
+                if (*trunc) {
+                    return p;
+                }
+                break;
+            }
+            case 'n':
+                (void)va_arg(args, void *);
+                break;
+            default:
+                return p;       /* ֵ֧תطʱڴֹͣ */
+        }
+    }
+    if (p == NULL) {
+        *trunc = true;
+        return done;
+    }
+    return p;
+}
+
+/* ֵ + 1  ulog_level_map0 Ϊ RAW м¼ */
+static inline bool flight_captures(char level)
+{
+    uint8_t lv = ulog_level_map[level & 0x1F];
+    return level && (lv == 0 || lv - 1 > LOG_FLIGHT_LEVEL);
+}
+
+static inline bool flight_triggers(char level)
+{
+    uint8_t lv = ulog_level_map[level & 0x1F];
+    return level && lv != 0 && lv - 1 <= LOG_FLIGHT_TRIGGER;
+}
+
+static void flight_capture(unsigned char terminal, char level, const char *tag,
+                           const char *fmt, va_list args)
+{
+    unsigned n = atomic_fetch_add_explicit(&ulog_flight.head, 1, memory_order_relaxed);
+    ulog_flight_slot_t *slot = &ulog_flight.slot[n & (LOG_FLIGHT_SLOTS - 1)];
+    unsigned cur = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+
+    /* д룬ѱµļ¼ռã߱ռһȦϣһʱ lost */
+    if ((cur & 1u) || (int)(2 * n + 1 - cur) <= 0 ||
+        !atomic_compare_exchange_strong_explicit(&slot->seq, &cur, 2 * n + 1,
+                                                 memory_order_acquire, memory_order_relaxed)) {
+        return;
+    }
+    atomic_thread_fence(memory_order_release);
+
+    ulog_flight_rec_t *r = &slot->rec;
+    if (tag == NULL) {
+        tag = "";
+    }
+    size_t tag_len = strlen(tag);
+    if (tag_len > LOG_FLIGHT_DATA_SIZE / 2) {
+        tag_len = LOG_FLIGHT_DATA_SIZE / 2;
+    }
+    r->fmt      = fmt;
+#if ULOG_WITH_TIMESTAMP
+    ts_now(&r->sec, &r->usec);
+#endif
+    r->level    = level;
+    r->terminal = terminal;
+    r->tag_len  = (uint8_t)tag_len;
+    r->trunc    = false;
+    memcpy(r->data, tag, tag_len);
+
+    uint8_t *p = flight_pack(r->data + tag_len, r->data + sizeof(r->data), fmt, args, &r->trunc);
+    r->len = (uint8_t)(p - r->data);
+
+    atomic_store_explicit(&slot->seq, 2 * n + 2, memory_order_release);
+}
+
+static const uint8_t *flight_get(const uint8_t *p, const uint8_t *end, void *v, size_t n)
+{
+    if (p == NULL || n > (size_t)(end - p)) {
+        return NULL;
+    }
+    memcpy(v, p, n);
+    return p + n;
+}
+
+/* ת˵ ulog_vformatԭ´ */
+static void flight_vput(ulog_out_t *o, const char *spec, ...)
+{
+    va_list args;
+    va_start(args, spec);
+    ulog_vformat(o, spec, args);
+    va_end(args);
+}
+
+static void flight_spec_int(char **q, int v)
+{
+    char tmp[12];
+    int n = 0;
+    unsigned u = (v < 0) ? 0u - (unsigned)v : (unsigned)v;
+
+    if (v < 0) {
+        *(*q)++ = '-';
+    }
+    do {
+        tmp[n++] = (char)('0' + u % 10u);
+        u /= 10u;
+    } while (u);
+    while (n) {
+        *(*q)++ = tmp[--n];
+    }
+}
+
+/* ʽʹµĲ¸ʽÿת˵е * ɴµֵ
+ * ûдȫtruncʱµĲֹͣ */
+static void flight_format(ulog_out_t *o, const char *f, const uint8_t *p, const uint8_t *end, bool trunc)
+{
+    while (*f) {
+        const char *start = f;
+        while (*f && *f != '%') {
+            f++;
+        }
+        out_mem(o, start, (size_t)(f - start));
+        if (*f == '\0') {
+            return;
+        }
+
+        char spec[40];
+        char *q = spec;
+        int iv = 0;
+        *q++ = *f++;
+        if (*f == '%') {
+            out_char(o, '%');
+            f++;
+            continue;
+        }
+        while (*f == '-' || *f == '+' || *f == ' ' || *f == '#' || *f == '0') {
+            if (q < spec + 8) {
+                *q++ = *f;
+            }
+            f++;
+        }
+        if (*f == '*') {
+            p = flight_get(p, end, &iv, sizeof(iv));
+            flight_spec_int(&q, iv);
+            f++;
+        }
+        while (*f >= '0' && *f <= '9') {
+            if (q < spec + 20) {
+                *q++ = *f;
+            }
+            f++;
+        }
+        if (*f == '.') {
+            f++;
+            if (*f == '*') {
+                p = flight_get(p, end, &iv, sizeof(iv));
+                if (iv >= 0) {
+                    *q++ = '.';
+                    flight_spec_int(&q, iv);
+                }
+                f++;
+            } else {
+                *q++ = '.';
+            }
+            while (*f >= '0' && *f <= '9') {
+                if (q < spec + 34) {
+                    *q++ = *f;
+                }
+                f++;
+            }
+        }
+
+        char lm = 0;
+        switch (*f) {
+            case 'h': *q++ = *f++; if (*f == 'h') *q++ = *f++; break;
+            case 'l': lm = 'l'; *q++ = *f++; if (*f == 'l') { lm = 'q'; *q++ = *f++; } break;
+            case 'j': lm = 'q'; *q++ = *f++; break;
+            case 'z': case 't': lm = 'z'; *q++ = *f++; break;
+            case 'L': f++; break;   /*  double */
+            default : break;
+        }
+        char conv = *f++;
+        if (lm == 'l' && conv == 'c') {
+            lm = 'w';
+        } else if (lm == 'l' && conv == 's') {
+            q--;                    /* %ls ¼ʱתɶֽڴ %s ط */
+        }
+        *q++ = conv;
+        *q = '\0';
+        if (p == NULL) {
+            return;
+        }
+
+        switch (conv) {
+            case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+                if (lm == 'q') {
+                    long long v;
+                    if ((p = flight_get(p, end, &v, sizeof(v))) != NULL) flight_vput(o, spec, v);
+                } else if (lm == 'w') {
+                    wint_t v;
+                    if ((p = flight_get(p, end, &v, sizeof(v))) != NULL) flight_vput(o, spec, v);
+                } else if (lm == 'l') {
+                    long v;
+                    if ((p = flight_get(p, end, &v, sizeof(v))) != NULL) flight_vput(o, spec, v);
+                } else if (lm == 'z') {
+                    intptr_t v;
+                    if ((p = flight_get(p, end, &v, sizeof(v))) != NULL) flight_vput(o, spec, v);
+                } else {
+                    int v;
+                    if ((p = flight_get(p, end, &v, sizeof(v))) != NULL) flight_vput(o, spec, v);
+                }
+                break;
+            case 'p': {
+                void *v;
+                if ((p = flight_get(p, end, &v, sizeof(v))) != NULL) flight_vput(o, spec, v);
+                break;
+            }
+            case 'f': case 'F': case 'e': case 'E':
+            case 'g': case 'G': case 'a': case 'A': {
+                double d;
+                if ((p = flight_get(p, end, &d, sizeof(d))) != NULL) flight_vput(o, spec, d);
+                break;
+            }
+            case 's': {
+                char s[LOG_FLIGHT_DATA_SIZE];
+                uint8_t n;
+                if ((p = flight_get(p, end, &n, 1)) != NULL && (p = flight_get(p, end, s, n)) != NULL) {
+                    s[n] = '\0';
+                    flight_vput(o, spec, s);
+                }
+                break;
+            }
+            case 'n':
+                break;
+            default:
+                return;
+        }
+        if (p == NULL || (trunc && p == end)) {
+            return;
+        }
+    }
+}
+
+static void flight_emit(const ulog_flight_rec_t *r)
+{
+    char buffer[ULOG_BUFFER_SIZE];
+    ulog_out_t o = { buffer, sizeof(buffer) - 1, 0, false };
+    const uint8_t *data = r->data + r->tag_len;
+    char tag[LOG_FLIGHT_DATA_SIZE / 2 + 1];
+    size_t pre_len;
+
+    memcpy(tag, r->data, r->tag_len);
+    tag[r->tag_len] = '\0';
+    log_put_tag(&o, r->level, tag);
+#if ULOG_WITH_TIMESTAMP
+    log_put_timestamp_at(&o, r->sec, r->usec);
+    out_char(&o, ' ');
+#endif
+    pre_len = o.len;
+    flight_format(&o, r->fmt, data, r->data + r->len, r->trunc);
+    /* ûдȫʱ뻺ضһ "..." β */
+    o.truncated |= r->trunc;
+    log_finish(&o, r->fmt, &pre_len);
+    log_commit(r->terminal, r->level, tag, buffer, o.len, pre_len, false);
+}
+
+/* ˳δʷͬһʱֻһִߣֱӷ */
+static void flight_flush(void)
+{
+    if (atomic_exchange_explicit(&ulog_flight.busy, true, memory_order_acquire)) {
+        return;
+    }
+    atomic_store_explicit(&ulog_flight.pending, false, memory_order_relaxed);
+
+    unsigned end   = atomic_load_explicit(&ulog_flight.head, memory_order_acquire);
+    unsigned start = ulog_flight.read;
+    unsigned lost  = 0;
+    unsigned count = 0;
+
+    if (end - start > LOG_FLIGHT_SLOTS) {
+        lost  = end - start - LOG_FLIGHT_SLOTS;
+        start = end - LOG_FLIGHT_SLOTS;
+    }
+    if (start != end) {
+        log_commit_fmt(0, "", "---- flight recorder: %u records ----\r\n", end - start);
+    }
+    for (unsigned n = start; n != end; n++) {
+        ulog_flight_slot_t *slot = &ulog_flight.slot[n & (LOG_FLIGHT_SLOTS - 1)];
+        ulog_flight_rec_t rec;
+
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != 2 * n + 2) {
+            lost++;
+            continue;
+        }
+        memcpy(&rec, &slot->rec, sizeof(rec));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != 2 * n + 2) {
+            lost++;
+            continue;
+        }
+        flight_emit(&rec);
+        count++;
+    }
+    if (start != end || lost) {
+        log_commit_fmt(0, "", "---- end of flight recorder, %u lost ----\r\n", lost);
+    }
+    ulog_flight.read = end;
+    atomic_fetch_add_explicit(&ulog_flight.flushed, count, memory_order_relaxed);
+    atomic_fetch_add_explicit(&ulog_flight.lost, lost, memory_order_relaxed);
+    atomic_store_explicit(&ulog_flight.busy, false, memory_order_release);
+}
+
+static void flight_pending_flush(void)
+{
+    if (atomic_load_explicit(&ulog_flight.pending, memory_order_relaxed) && !ULOG_IN_ISR()) {
+        flight_flush();
+    }
+}
+
+void ulog_flight_flush(void)
+{
+    flight_flush();
+}
+
+/* δʷ */
+void ulog_flight_clear(void)
+{
+    if (atomic_exchange_explicit(&ulog_flight.busy, true, memory_order_acquire)) {
+        return;
+    }
+    ulog_flight.read = atomic_load_explicit(&ulog_flight.head, memory_order_acquire);
+    atomic_store_explicit(&ulog_flight.busy, false, memory_order_release);
+}
+
+void ulog_flight_get_stats(ulog_flight_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    stats->captured = atomic_load_explicit(&ulog_flight.head, memory_order_relaxed);
+    stats->flushed  = atomic_load_explicit(&ulog_flight.flushed, memory_order_relaxed);
+    stats->lost     = atomic_load_explicit(&ulog_flight.lost, memory_order_relaxed);
+}
+#endif /* LOG_ENABLE_FLIGHT */
+
+/* -------------------------------------------------------------------------- */
+/* ĺͳһ־                                                     */
+/* -------------------------------------------------------------------------- */
+#if !ULOG_OUTPUT_DISABLE
+static ULOG_ALWAYS_INLINE void log_output_v(ulog_site_t *site, unsigned char terminal_id, char level,
+                                            const char *tag, const char *fmt, va_list args)
+{
+#if LOG_ENABLE_FLIGHT
+    /* ϸ־ֻм¼ж */
+    if (flight_captures(level)) {
+        flight_capture(terminal_id, level, tag, fmt, args);
+        return;
+    }
+#endif
+    /* ε־ڸʽ֮ǰ */
+    if (!log_gate(level, tag, tag)) {
+#if LOG_ENABLE_STATS
+        ulog_stats_suppress(site, level, tag);
+#endif
+        return;
+    }
+    (void)site;
+#if LOG_ENABLE_FLIGHT
+    /* ERROR/ASSERT ֮ǰʷ */
+    if (flight_triggers(level)) {
+        flight_flush();
+    } else {
+        flight_pending_flush();
+    }
+#endif
+
+#if LOG_ENABLE_STATS
+    uint32_t t0 = stats_cycles();
+#endif
+#if LOG_ENABLE_RECORD_POOL
+    /* ڳеĲʽؿʱ˻ؽСջ */
+    char fallback[LOG_POOL_FALLBACK_SIZE];
+    char *buffer = pool_get();
+    size_t size = LOG_POOL_SLOT_SIZE;
+    if (buffer == NULL) {
+        buffer = fallback;
+        size   = sizeof(fallback);
+    }
+#else
+    char buffer[ULOG_BUFFER_SIZE];
+    size_t size = sizeof(buffer);
+#endif
+    size_t pre_len;
+    int len = format_log_message(buffer, size, &pre_len, level, tag, fmt, args);
+
+#if LOG_ENABLE_FILTER
+    if (level && !filter_keyword_pass(buffer)) {
+#if LOG_ENABLE_STATS
+        ulog_stats_suppress(site, level, tag);
+#endif
+    } else
+#endif
+    {
+#if LOG_ENABLE_STATS
+        uint32_t t1 = stats_cycles();
+        log_commit(terminal_id, level, tag, buffer, (size_t)len, pre_len, false);
+        stats_emitted(site, level, tag, (size_t)len, t1 - t0, stats_cycles() - t1);
+#else
+        log_commit(terminal_id, level, tag, buffer, (size_t)len, pre_len, false);
+#endif
+    }
+#if LOG_ENABLE_RECORD_POOL
+    if (buffer != fallback) {
+        pool_put(buffer);
+    }
+#endif
+#if LOG_ENABLE_STATS && LOG_STATS_DUMP_MS
+    stats_poll();
+#endif
+#if LOG_ENABLE_METRIC && LOG_METRIC_PERIOD_MS
+    metric_poll();
+#endif
+}
+#endif
+
+void ulog_output_ex(unsigned char terminal_id,
+                                         char level, const char *tag,
+                                         const char *fmt, ...)
+{
+#if !ULOG_OUTPUT_DISABLE
+    va_list args;
+    va_start(args, fmt);
+    log_output_v(NULL, terminal_id, level, tag, fmt, args);
+    va_end(args);
+#endif
+}
+
+#if LOG_ENABLE_STATS
+/* ͳƿʱ꾭ɴ˴ϵõ */
+void ulog_output_site(ulog_site_t *site, unsigned char terminal_id, char level, const char *tag,
+                      const char *fmt, ...)
+{
+#if !ULOG_OUTPUT_DISABLE
+    va_list args;
+    va_start(args, fmt);
+    log_output_v(site, terminal_id, level, tag, fmt, args);
+    va_end(args);
+#endif
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* ɵȾĵ                                                 */
+/* -------------------------------------------------------------------------- */
+#if LOG_ENABLE_FLIGHT
+static void flight_capture_f(unsigned char terminal, char level, const char *tag, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    flight_capture(terminal, level, tag, fmt, args);
+    va_end(args);
+}
+#endif
+
+/* ǰ׺дú render ֱд¼ʽ֮׷ "\r\n"
+ * м¼־Ⱦ̻ "%s" 档 */
+void ulog_output_render(unsigned char terminal_id, char level, const char *tag,
+                        ulog_render_fn render, const void *ctx)
+{
+#if !ULOG_OUTPUT_DISABLE
+#if LOG_ENABLE_FLIGHT
+    if (flight_captures(level)) {
+        char body[LOG_FLIGHT_DATA_SIZE + 1];    /* һַŲʱ flight_pack ǽض */
+        size_t n = render(body, sizeof(body) - 1, ctx);
+        body[(n < sizeof(body) - 1) ? n : sizeof(body) - 1] = '\0';
+        flight_capture_f(terminal_id, level, tag, "%s\r\n", body);
+        return;
+    }
+#endif
+    if (!log_gate(level, tag, tag)) {
+#if LOG_ENABLE_STATS
+        ulog_stats_suppress(NULL, level, tag);
+#endif
+        return;
+    }
+#if LOG_ENABLE_FLIGHT
+    if (flight_triggers(level)) {
+        flight_flush();
+    } else {
+        flight_pending_flush();
+    }
+#endif
+
+#if LOG_ENABLE_STATS
+    uint32_t t0 = stats_cycles();
+#endif
+#if LOG_ENABLE_RECORD_POOL
+    char fallback[LOG_POOL_FALLBACK_SIZE];
+    char *buffer = pool_get();
+    size_t size = LOG_POOL_SLOT_SIZE;
+    if (buffer == NULL) {
+        buffer = fallback;
+        size   = sizeof(fallback);
+    }
+#else
+    char buffer[ULOG_BUFFER_SIZE];
+    size_t size = sizeof(buffer);
+#endif
+    ulog_out_t o = { buffer, size - 1, 0, false };
+    size_t pre_len;
+
+    log_put_prefix(&o, level, tag);
+    pre_len = o.len;
+    /* Ϊ "\r\n" λ */
+    size_t room = (o.size > o.len + 2) ? o.size - o.len - 2 : 0;
+    size_t n = render(buffer + o.len, room, ctx);
+    if (n > room) {
+        n = room;
+        o.truncated = true;
+    }
+    o.len += n;
+    out_mem(&o, "\r\n", 2);
+    log_finish(&o, "\r\n", &pre_len);
+
+#if LOG_ENABLE_FILTER
+    if (level && !filter_keyword_pass(buffer)) {
+#if LOG_ENABLE_STATS
+        ulog_stats_suppress(NULL, level, tag);
+#endif
+    } else
+#endif
+    {
+#if LOG_ENABLE_STATS
+        uint32_t t1 = stats_cycles();
+        log_commit(terminal_id, level, tag, buffer, o.len, pre_len, false);
+        stats_emitted(NULL, level, tag, o.len, t1 - t0, stats_cycles() - t1);
+#else
+        log_commit(terminal_id, level, tag, buffer, o.len, pre_len, false);
+#endif
+    }
+#if LOG_ENABLE_RECORD_POOL
+    if (buffer != fallback) {
+        pool_put(buffer);
+    }
+#endif
+#if LOG_ENABLE_STATS && LOG_STATS_DUMP_MS
+    stats_poll();
+#endif
+#if LOG_ENABLE_METRIC && LOG_METRIC_PERIOD_MS
+    metric_poll();
+#endif
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+/* жר                                                               */
+/* -------------------------------------------------------------------------- */
+/*  LOG_ISR_BUFFER_SIZE ջиʽԤύೢ
+ * LOG_ISR_RESERVE_TRIES Σʧܼȴúˣִʱޡ
+ * ¼ɺ̨첽ģʽһе־ / ulog_flush()ͬģʽ
+ * ûύ޴ݴ棬ֻڿ LOG_ENABLE_ASYNC  LOG_ENABLE_THREAD_SAFE ʱṩ */
+#if ULOG_USE_RING
+void ulog_output_isr(unsigned char terminal_id, char level, const char *tag,
+                     const char *fmt, ...)
+{
+#if !ULOG_OUTPUT_DISABLE
+#if LOG_ENABLE_FLIGHT
+    if (flight_captures(level)) {
+        va_list args;
+        va_start(args, fmt);
+        flight_capture(terminal_id, level, tag, fmt, args);
+        va_end(args);
+        return;
+    }
+    /* жвʷһĵ־ ulog_flush() */
+    if (flight_triggers(level)) {
+        atomic_store_explicit(&ulog_flight.pending, true, memory_order_relaxed);
+    }
+#endif
+    if (!log_gate(level, tag, tag)) {
+#if LOG_ENABLE_STATS
+        ulog_stats_suppress(NULL, level, tag);
+#endif
+        return;
+    }
+
+#if LOG_ENABLE_STATS
+    uint32_t t0 = stats_cycles();
+#endif
+    char buffer[LOG_ISR_BUFFER_SIZE];
+    size_t pre_len;
+    va_list args;
+    va_start(args, fmt);
+    int len = format_log_message(buffer, sizeof(buffer), &pre_len, level, tag, fmt, args);
+    va_end(args);
+
+#if LOG_ENABLE_FILTER
+    if (level && !filter_keyword_pass(buffer)) {
+#if LOG_ENABLE_STATS
+        ulog_stats_suppress(NULL, level, tag);
+#endif
+        return;
+    }
+#endif
+#if LOG_ENABLE_STATS
+    uint32_t t1 = stats_cycles();
+    log_commit(terminal_id, level, tag, buffer, (size_t)len, pre_len, true);
+    stats_emitted(NULL, level, tag, (size_t)len, t1 - t0, stats_cycles() - t1);
+#else
+    log_commit(terminal_id, level, tag, buffer, (size_t)len, pre_len, true);
+#endif
+#endif
+}
+#endif /* ULOG_USE_RING */
+
+#if ULOG_USE_BIN_OUT
+/* -------------------------------------------------------------------------- */
+/* Ƽ¼־ṹ־ TLV                       */
+/* -------------------------------------------------------------------------- */
+static uint8_t *bin_put_varint(uint8_t *p, const uint8_t *end, uint64_t v)
+{
+    uint32_t lo = (uint32_t)v;
+
+    /*  32 λֵ߿· */
+    if (v == lo) {
+        while (lo >= 0x80 && p < end) {
+            *p++ = (uint8_t)(lo | 0x80);
+            lo >>= 7;
+        }
+    } else {
+        while (v >= 0x80 && p < end) {
+            *p++ = (uint8_t)(v | 0x80);
+            v >>= 7;
+        }
+        lo = (uint32_t)v;
+    }
+    if (p >= end) {
+        return NULL;
+    }
+    *p++ = (uint8_t)lo;
+    return p;
+}
+
+static uint8_t *bin_put_signed(uint8_t *p, const uint8_t *end, int64_t v)
+{
+    return bin_put_varint(p, end, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+static uint8_t *bin_put_bytes(uint8_t *p, const uint8_t *end, const void *src, size_t n)
+{
+    if ((size_t)(end - p) < n) {
+        return NULL;
+    }
+    memcpy(p, src, n);
+    return p + n;
+}
+
+static void log_backend_binary(unsigned channel, const uint8_t *rec, size_t len)
+{
+#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_RTT) && (SUPPORT_SEGGER_RTT == 1)
+    SEGGER_RTT_Write(channel, rec, len);
+#endif
+#if (ULOG_OUTPUT_METHOD & ULOG_OUTPUT_PRINTF)
+    fwrite(rec, 1, len, stdout);
+#endif
+    /* EasyLogger ֻıƼ¼ */
+    (void)channel;
+    (void)rec;
+    (void)len;
+}
+#endif /* ULOG_USE_BIN_OUT */
+
+#if LOG_ENABLE_BINARY
+/* -------------------------------------------------------------------------- */
+/* ־¼ʽ                                                       */
+/* -------------------------------------------------------------------------- */
+/* 0xA0|flags, len, terminal, id(varint), [timestamp u32 LE], args...
+ *   flags bit0 : ʱ
+ *   flags bit1 : ض
+ *   len        : len ֽ֮
+ *   id         : Ŀ ulog_fmt ʼƫ
+ * ʽеתα룺
+ *    / ַ / ָ -> varintз zigzag
+ *                  -> 8 ֽ IEEE754 double LE
+ *   ַ             -> varint  + ֽ
+ */
+#define ULOG_BIN_SYNC       0xA0
+#define ULOG_BIN_F_TS       0x01
+#define ULOG_BIN_F_TRUNC    0x02
+
+extern const char __start_ulog_fmt[];
+
+/* -------------------------------------------------------------------------- */
+/* ־ֻʽȡʽ                             */
+/* -------------------------------------------------------------------------- */
+void ulog_bin_output(unsigned char terminal_id, const char *entry, ...)
+{
+#if !ULOG_OUTPUT_DISABLE
+    uint8_t rec[LOG_BINARY_RECORD_SIZE];
+    const uint8_t *end = rec + sizeof(rec);
+    uint8_t *p = rec + 3;
+    uint8_t flags = 0;
+    const char *f = entry + strlen(entry) + 1;     /* ͱǩ */
+    uint8_t *done;
+    va_list args;
+
+    /* ĿַΪǩڼַ֮ */
+    if (!log_gate(entry[0], entry, entry + 1)) {
+#if LOG_ENABLE_STATS
+        ulog_stats_suppress(NULL, entry[0], entry + 1);
+#endif
+        return;
+    }
+#if LOG_ENABLE_STATS
+    uint32_t t0 = stats_cycles();
+#endif
+
+    rec[2] = terminal_id;
+    p = bin_put_varint(p, end, (uint64_t)(entry - __start_ulog_fmt));
+#if ULOG_WITH_TIMESTAMP
+    uint32_t ts = ulog_get_timestamp();
+    p = bin_put_bytes(p, end, &ts, sizeof(ts));     /* Cortex-M  x86 ΪС */
+    flags |= ULOG_BIN_F_TS;
+#endif
+
+    va_start(args, entry);
+    done = p;
+    while (p != NULL && *f) {
+        if (*f++ != '%') {
+            continue;
+        }
+        if (*f == '%') {
+            f++;
+            continue;
+        }
+        done = p;   /* һĲλ */
+        /* ־ȡ */
+        while (*f == '-' || *f == '+' || *f == ' ' || *f == '#' || *f == '0') {
+            f++;
+        }
+        if (*f == '*') {
+            p = bin_put_signed(p, end, va_arg(args, int));
+            f++;
+        }
+        while (*f >= '0' && *f <= '9') {
+            f++;
+        }
+        if (*f == '.') {
+            f++;
+            if (*f == '*') {
+                p = p ? bin_put_signed(p, end, va_arg(args, int)) : NULL;
+                f++;
+            }
+            while (*f >= '0' && *f <= '9') {
+                f++;
+            }
+        }
+        if (p == NULL) {
+            break;
+        }
+
+        /* η */
+        char lm = 0;
+        switch (*f) {
+            case 'h': lm = 'h'; f++; if (*f == 'h') f++; break;
+            case 'l': lm = 'l'; f++; if (*f == 'l') { lm = 'q'; f++; } break;
+            case 'j': lm = 'q'; f++; break;
+            case 'z': lm = 'z'; f++; break;
+            case 't': lm = 'z'; f++; break;
+            case 'L': lm = 'L'; f++; break;
+            default : break;
+        }
+        if (lm == 'l' && *f == 'c') {
+            lm = 'w';       /* %lc Ĳ wint_t */
+        }
+
+        switch (*f++) {
+            case 'd': case 'i':
+                if (lm == 'q')      p = bin_put_signed(p, end, va_arg(args, long long));
+                else if (lm == 'l') p = bin_put_signed(p, end, va_arg(args, long));
+                else if (lm == 'z') p = bin_put_signed(p, end, (int64_t)va_arg(args, intptr_t));
+                else                p = bin_put_signed(p, end, va_arg(args, int));
+                break;
+            case 'u': case 'x': case 'X': case 'o': case 'c':
+                if (lm == 'q')      p = bin_put_varint(p, end, va_arg(args, unsigned long long));
+                else if (lm == 'w') p = bin_put_varint(p, end, va_arg(args, wint_t));
+                else if (lm == 'l') p = bin_put_varint(p, end, va_arg(args, unsigned long));
+                else if (lm == 'z') p = bin_put_varint(p, end, va_arg(args, size_t));
+                else                p = bin_put_varint(p, end, va_arg(args, unsigned int));
+                break;
+            case 'p':
+                p = bin_put_varint(p, end, (uintptr_t)va_arg(args, void *));
+                break;
+            case 'f': case 'F': case 'e': case 'E':
+            case 'g': case 'G': case 'a': case 'A': {
+                double d = (lm == 'L') ? (double)va_arg(args, long double) : va_arg(args, double);
+                p = bin_put_bytes(p, end, &d, sizeof(d));
+                break;
+            }
+            case 's': {
+                const char *s;
+                size_t n;
+                char mb[LOG_BINARY_RECORD_SIZE];
+                if (lm == 'l') {
+                    /* %ls 豸תɶֽڴ %s  */
+                    bool full = false;
+                    n = wcs_to_mb(mb, sizeof(mb), va_arg(args, const wchar_t *), &full);
+                    s = mb;
+                } else {
+                    s = va_arg(args, const char *);
+                    n = (s != NULL) ? strlen(s) : 0;
+                }
+                size_t room = (size_t)(end - p);
+                if (n + (n < 0x80 ? 1 : 2) > room && room > 2) {
+                    /* дʱܷµǰ׺ж UTF-8 ַ */
+                    n = room - (room - 1 < 0x80 ? 1 : 2);
+                    while (n > 0 && ((uint8_t)s[n] & 0xC0) == 0x80) {
+                        n--;
+                    }
+                    p = bin_put_varint(p, end, n);
+                    p = p ? bin_put_bytes(p, end, s, n) : NULL;
+                    done = p;
+                    p = NULL;
+                    break;
+                }
+                p = bin_put_varint(p, end, n);
+                p = p ? bin_put_bytes(p, end, s, n) : NULL;
+                break;
+            }
+            case 'n':
+                (void)va_arg(args, void *);
+                break;
+            default:
+                f = "";     /* ֵ֧תֹͣ */
+                break;
+        }
+    }
+    va_end(args);
+
+    if (p == NULL) {
+        /* ¼ȣѱĲض̵ַǽض */
+        flags |= ULOG_BIN_F_TRUNC;
+        p = done;
+    }
+    rec[0] = (uint8_t)(ULOG_BIN_SYNC | flags);
+    rec[1] = (uint8_t)(p - rec - 2);
+#if LOG_ENABLE_STATS
+    uint32_t t1 = stats_cycles();
+    log_backend_binary(LOG_BINARY_RTT_CHANNEL, rec, (size_t)(p - rec));
+    stats_emitted(NULL, entry[0], entry + 1, (size_t)(p - rec), t1 - t0, stats_cycles() - t1);
+#else
+    log_backend_binary(LOG_BINARY_RTT_CHANNEL, rec, (size_t)(p - rec));
+#endif
+#endif
+}
+#endif /* LOG_ENABLE_BINARY */
+
+#if LOG_ENABLE_KV
+#if (LOG_KV_FORMAT == ULOG_KV_JSON)
+/* -------------------------------------------------------------------------- */
+/* ṹ־JSON                                                       */
+/* -------------------------------------------------------------------------- */
+/* Ϊ {"msg":"...","key":value,...}\r\nдµļֵ
+ *  "trunc":true β֤ÿ JSON  */
+#if (LOG_KV_FLOAT_DIGITS < 0) || (LOG_KV_FLOAT_DIGITS > 9)
+#error "LOG_KV_FLOAT_DIGITS must be 0..9"
+#endif
+
+#define KV_JSON_TAIL        ",\"trunc\":true}\r\n"
+
+static const char kv_hex[] = "0123456789abcdef";
+
+/* ŵַתддضʱдβ */
+static void json_put_str(ulog_out_t *o, const char *s, size_t n)
+{
+    const char *end = s + n;
+
+    out_char(o, '"');
+    while (s < end) {
+        const char *run = s;
+        while (s < end && (uint8_t)*s >= 0x20 && *s != '"' && *s != '\\') {
+            s++;
+        }
+        out_mem(o, run, (size_t)(s - run));
+        if (s == end || o->truncated) {
+            break;
+        }
+
+        char esc[6] = { '\\', *s, 0, 0, 0, 0 };
+        size_t k = 2;
+        switch (*s) {
+            case '"': case '\\': break;
+            case '\n': esc[1] = 'n'; break;
+            case '\r': esc[1] = 'r'; break;
+            case '\t': esc[1] = 't'; break;
+            default:
+                esc[1] = 'u'; esc[2] = '0'; esc[3] = '0';
+                esc[4] = kv_hex[((uint8_t)*s >> 4) & 0xF];
+                esc[5] = kv_hex[*s & 0xF];
+                k = 6;
+                break;
+        }
+        if (o->size - o->len < k) {
+            o->truncated = true;
+            return;
+        }
+        out_mem(o, esc, k);
+        s++;
+    }
+    out_char(o, '"');
+}
+
+/* ǸдСȥĩβ 0 */
+static void json_put_fixed(ulog_out_t *o, double v)
+{
+    static const uint32_t scale_tab[] = {
+        1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+    };
+    const uint32_t scale = scale_tab[LOG_KV_FLOAT_DIGITS];
+    uint64_t ip = (uint64_t)v;
+    uint32_t fp = (uint32_t)((v - (double)ip) * scale + 0.5);
+    int digits = LOG_KV_FLOAT_DIGITS;
+
+    if (fp >= scale) {
+        ip++;
+        fp -= scale;
+    }
+    out_number(o, ip, 10, false, "", 0, 0, -1);
+    if (fp == 0) {
+        return;
+    }
+    while (fp % 10 == 0) {
+        fp /= 10;
+        digits--;
+    }
+    out_char(o, '.');
+    out_number(o, fp, 10, false, "", FMT_ZERO, digits, -1);
+}
+
+/* JSON û NaN/InfдΪ null㷶Χÿѧ */
+static void json_put_double(ulog_out_t *o, double v)
+{
+    int e = 0;
+
+    if (v - v != 0.0) {
+        out_mem(o, "null", 4);
+        return;
+    }
+    if (v < 0) {
+        out_char(o, '-');
+        v = -v;
+    }
+    if (v >= 1e15) {
+        while (v >= 10.0) {
+            v /= 10.0;
+            e++;
+        }
+    } else if (v > 0 && v < 1e-4) {
+        while (v < 1.0) {
+            v *= 10.0;
+            e--;
+        }
+    }
+    json_put_fixed(o, v);
+    if (e != 0) {
+        out_char(o, 'e');
+        out_number(o, (unsigned)(e < 0 ? -e : e), 10, false, (e < 0) ? "-" : "+", 0, 0, -1);
+    }
+}
+
+static void json_put_value(ulog_out_t *o, const ulog_kv_t *kv)
+{
+    switch (kv->type) {
+        case ULOG_KV_T_BOOL:
+            if (kv->v.i) out_mem(o, "true", 4);
+            else         out_mem(o, "false", 5);
+            break;
+        case ULOG_KV_T_INT:
+            if (kv->v.i < 0) out_number(o, 0ull - (uint64_t)kv->v.i, 10, false, "-", 0, 0, -1);
+            else             out_number(o, (uint64_t)kv->v.i, 10, false, "", 0, 0, -1);
+            break;
+        case ULOG_KV_T_UINT:
+            out_number(o, kv->v.u, 10, false, "", 0, 0, -1);
+            break;
+        case ULOG_KV_T_FLOAT:
+            json_put_double(o, kv->v.f);
+            break;
+        case ULOG_KV_T_STR:
+            if (kv->v.s != NULL) json_put_str(o, kv->v.s, strlen(kv->v.s));
+            else                 out_mem(o, "null", 4);
+            break;
+        case ULOG_KV_T_BYTES: {
+            /* ʮַ */
+            const uint8_t *p = (const uint8_t *)kv->v.p;
+            out_char(o, '"');
+            for (size_t i = 0; i < kv->len && !o->truncated; i++) {
+                out_char(o, kv_hex[p[i] >> 4]);
+                out_char(o, kv_hex[p[i] & 0xF]);
+            }
+            out_char(o, '"');
+            break;
+        }
+        default:
+            out_mem(o, "null", 4);
+            break;
+    }
+}
+
+static size_t kv_encode_json(char *buf, size_t size, size_t *pre_len, char level, const char *tag,
+                             const char *msg, const ulog_kv_t *kv, size_t count)
+{
+    const size_t tail = sizeof(KV_JSON_TAIL) - 1;
+    ulog_out_t o = { buf, size - 1, 0, false };
+    bool open_str = false;
+
+    log_put_prefix(&o, level, tag);
+    *pre_len = o.len;
+
+    /* Ԥβֵдʱ˵һļֵ */
+    o.size = (o.size > o.len + tail) ? o.size - tail : o.len;
+    out_mem(&o, "{\"msg\":", 7);
+    json_put_str(&o, (msg != NULL) ? msg : "", (msg != NULL) ? strlen(msg) : 0);
+    open_str = o.truncated;
+    for (size_t i = 0; i < count && !o.truncated; i++) {
+        size_t keep = o.len;
+        out_char(&o, ',');
+        json_put_str(&o, kv[i].key, strlen(kv[i].key));
+        out_char(&o, ':');
+        json_put_value(&o, &kv[i]);
+        if (o.truncated) {
+            o.len = keep;
+        }
+    }
+
+    o.size = size - 1;
+    if (o.truncated) {
+        if (open_str) {
+            out_char(&o, '"');
+        }
+        out_mem(&o, KV_JSON_TAIL, tail);
+    } else {
+        out_mem(&o, "}\r\n", 3);
+    }
+    buf[o.len] = '\0';
+    return o.len;
+}
+
+#else /* ULOG_KV_TLV */
+/* -------------------------------------------------------------------------- */
+/* ṹ־TLV                                                        */
+/* -------------------------------------------------------------------------- */
+/* 0xB0|flags, len(u16 LE), terminal, level, tag_len, tag, [timestamp u32 LE],
+ * msg_len(varint), msg, ֵ...
+ *   flags ͬ־bit0 ʱbit1 мֵŲ±
+ *   len   : len ֽ֮
+ * ֵԣtype, key_len, key, value
+ *   BOOL -> 1 ֽڣINT -> zigzag varintUINT -> varint
+ *   FLOAT -> 8 ֽ IEEE754 double LESTR / BYTES -> varint  + ֽ
+ * ־ļ¼ԳͬһУtools/ulog_decode.py ֽͬ֡ */
+#define ULOG_KV_SYNC        0xB0
+#define ULOG_KV_F_TS        0x01
+#define ULOG_KV_F_TRUNC     0x02
+#define ULOG_KV_TAG_MAX     32
+
+static uint8_t *kv_put_tlv(uint8_t *p, const uint8_t *end, const ulog_kv_t *kv)
+{
+    size_t klen = strlen(kv->key);
+
+    if (klen > 0xFF) {
+        klen = 0xFF;
+    }
+    if ((size_t)(end - p) < 2 + klen) {
+        return NULL;
+    }
+    *p++ = kv->type;
+    *p++ = (uint8_t)klen;
+    memcpy(p, kv->key, klen);
+    p += klen;
+
+    switch (kv->type) {
+        case ULOG_KV_T_BOOL: {
+            uint8_t b = kv->v.i ? 1 : 0;
+            return bin_put_bytes(p, end, &b, 1);
+        }
+        case ULOG_KV_T_INT:
+            return bin_put_signed(p, end, kv->v.i);
+        case ULOG_KV_T_UINT:
+            return bin_put_varint(p, end, kv->v.u);
+        case ULOG_KV_T_FLOAT:
+            return bin_put_bytes(p, end, &kv->v.f, sizeof(double));
+        case ULOG_KV_T_STR: {
+            size_t n = (kv->v.s != NULL) ? strlen(kv->v.s) : 0;
+            p = bin_put_varint(p, end, n);
+            return p ? bin_put_bytes(p, end, kv->v.s, n) : NULL;
+        }
+        case ULOG_KV_T_BYTES:
+            p = bin_put_varint(p, end, kv->len);
+            return p ? bin_put_bytes(p, end, kv->v.p, kv->len) : NULL;
+        default:
+            return NULL;
+    }
+}
+
+static size_t kv_encode_tlv(uint8_t *rec, size_t size, unsigned char terminal, char level,
+                            const char *tag, const char *msg, const ulog_kv_t *kv, size_t count)
+{
+    const uint8_t *end = rec + size;
+    uint8_t *p = rec + 3;
+    uint8_t flags = 0;
+    size_t tag_len = (tag != NULL) ? strlen(tag) : 0;
+    size_t msg_len = (msg != NULL) ? strlen(msg) : 0;
+
+    if (tag_len > ULOG_KV_TAG_MAX) {
+        tag_len = ULOG_KV_TAG_MAX;
+    }
+    *p++ = terminal;
+    *p++ = (uint8_t)level;
+    *p++ = (uint8_t)tag_len;
+    memcpy(p, tag, tag_len);
+    p += tag_len;
+#if ULOG_WITH_TIMESTAMP
+    uint32_t ts = ulog_get_timestamp();
+    memcpy(p, &ts, sizeof(ts));     /* Cortex-M  x86 ΪС */
+    p += sizeof(ts);
+    flags |= ULOG_KV_F_TS;
+#endif
+
+    /* ϢŲʱضֵ̣ԷŲʱ */
+    if (msg_len > (size_t)(end - p) - 3) {
+        msg_len = (size_t)(end - p) - 3;
+        flags |= ULOG_KV_F_TRUNC;
+    }
+    p = bin_put_varint(p, end, msg_len);
+    p = bin_put_bytes(p, end, msg, msg_len);
+    for (size_t i = 0; i < count; i++) {
+        uint8_t *next = kv_put_tlv(p, end, &kv[i]);
+        if (next == NULL) {
+            flags |= ULOG_KV_F_TRUNC;
+            break;
+        }
+        p = next;
+    }
+
+    size_t len = (size_t)(p - rec) - 3;
+    rec[0] = (uint8_t)(ULOG_KV_SYNC | flags);
+    rec[1] = (uint8_t)len;
+    rec[2] = (uint8_t)(len >> 8);
+    return len + 3;
+}
+#endif /* LOG_KV_FORMAT */
+
+/* -------------------------------------------------------------------------- */
+/* ṹ־                                                             */
+/* -------------------------------------------------------------------------- */
+void ulog_kv_output(unsigned char terminal_id, char level, const char *tag,
+                    const char *msg, const ulog_kv_t *kv, size_t count)
+{
+#if !ULOG_OUTPUT_DISABLE
+    if (!log_gate(level, tag, tag)) {
+#if LOG_ENABLE_STATS
+        ulog_stats_suppress(NULL, level, tag);
+#endif
+        return;
+    }
+#if LOG_ENABLE_STATS
+    uint32_t t0 = stats_cycles();
+#endif
+
+#if LOG_ENABLE_RECORD_POOL
+    char fallback[LOG_POOL_FALLBACK_SIZE];
+    char *buffer = pool_get();
+    size_t size = LOG_POOL_SLOT_SIZE;
+    if (buffer == NULL) {
+        buffer = fallback;
+        size   = sizeof(fallback);
+    }
+#else
+    char buffer[ULOG_BUFFER_SIZE];
+    size_t size = sizeof(buffer);
+#endif
+
+#if (LOG_KV_FORMAT == ULOG_KV_JSON)
+    size_t pre_len;
+    size_t len = kv_encode_json(buffer, size, &pre_len, level, tag, msg, kv, count);
+#if LOG_ENABLE_FILTER
+    if (filter_keyword_pass(buffer))
+#endif
+    {
+#if LOG_ENABLE_STATS
+        uint32_t t1 = stats_cycles();
+        log_commit(terminal_id, level, tag, buffer, len, pre_len, false);
+        stats_emitted(NULL, level, tag, len, t1 - t0, stats_cycles() - t1);
+#else
+        log_commit(terminal_id, level, tag, buffer, len, pre_len, false);
+#endif
+    }
+#else
+    size_t len = kv_encode_tlv((uint8_t *)buffer, size, terminal_id, level, tag, msg, kv, count);
+#if LOG_ENABLE_STATS
+    uint32_t t1 = stats_cycles();
+    log_backend_binary(LOG_KV_RTT_CHANNEL, (const uint8_t *)buffer, len);
+    stats_emitted(NULL, level, tag, len, t1 - t0, stats_cycles() - t1);
+#else
+    log_backend_binary(LOG_KV_RTT_CHANNEL, (const uint8_t *)buffer, len);
+#endif
+#endif
+
+#if LOG_ENABLE_RECORD_POOL
+    if (buffer != fallback) {
+        pool_put(buffer);
+    }
+#endif
+#endif
+}
+#endif /* LOG_ENABLE_KV */
+
+/* -------------------------------------------------------------------------- */
+/* Hexdump                                                            */
+/* -------------------------------------------------------------------------- */
+/* Ⱦͬһһύʮƣѡ ASCII С
+ * ULOG_HEX_MAX_BYTES ƵֽULOG_HEX_PACE() ύ֮
+ * ãڸٺó */
+void ulog_hexdump_ex(unsigned char terminal_id, char level, const char *name,
+                     uint8_t width, const void *buf, size_t size)
+{
+#if !ULOG_OUTPUT_DISABLE
+    static const char hex[] = "0123456789ABCDEF";
+    const uint8_t *p = (const uint8_t *)buf;
+    size_t limit = size;
+    unsigned addr_digits = (size > 0x10000) ? 8 : 4;
+
+    if (!log_gate(level, NULL, NULL)) {
+        return;
+    }
+
+#if LOG_ENABLE_RECORD_POOL
+    char fallback[LOG_POOL_FALLBACK_SIZE];
+    char *out = pool_get();
+    size_t out_size = LOG_POOL_SLOT_SIZE;
+    if (out == NULL) {
+        out      = fallback;
+        out_size = sizeof(fallback);
+    }
+#else
+    char out[ULOG_BUFFER_SIZE];
+    size_t out_size = sizeof(out);
+#endif
+    ulog_out_t o = { out, out_size - 1, 0, false };
+
+    if (width == 0) {
+        width = ULOG_HEX_WIDTH;
+    }
+    if (width > (out_size - 16) / 4) {
+        width = (out_size - 16) / 4;
+    }
+#if ULOG_HEX_MAX_BYTES
+    if (limit > ULOG_HEX_MAX_BYTES) {
+        limit = ULOG_HEX_MAX_BYTES;
+    }
+#endif
+    size_t line_max = addr_digits + 2 + width * 3 + 2;
+#if ULOG_HEX_ASCII
+    line_max += 1 + width;
+#endif
+
+    // ӡ
+    out_mem(&o, "=== ", 4);
+    out_mem(&o, name, strlen(name));
+    out_mem(&o, " (", 2);
+    out_number(&o, size, 10, false, "", 0, 0, -1);
+    out_mem(&o, " bytes) ===\r\n", 13);
+
+    // ӡÿ
+    for (size_t i = 0; i < limit; i += width) {
+        if (o.size - o.len < line_max) {
+            out[o.len] = '\0';
+            log_commit(terminal_id, level, "", out, o.len, 0, false);
+            o.len = 0;
+            ULOG_HEX_PACE();
+        }
+
+        char *l = out + o.len;
+        size_t n = (limit - i < width) ? limit - i : width;
+
+        for (unsigned d = addr_digits; d-- > 0; ) {
+            *l++ = hex[(i >> (d * 4)) & 0x0F];
+        }
+        *l++ = ':';
+        *l++ = ' ';
+        for (size_t j = 0; j < n; j++) {
+            *l++ = hex[p[i + j] >> 4];
+            *l++ = hex[p[i + j] & 0x0F];
+            *l++ = ' ';
+        }
+#if ULOG_HEX_ASCII
+        for (size_t j = n; j < width; j++) {
+            *l++ = ' ';
+            *l++ = ' ';
+            *l++ = ' ';
+        }
+        *l++ = ' ';
+        for (size_t j = 0; j < n; j++) {
+            uint8_t c = p[i + j];
+            *l++ = (c >= 0x20 && c < 0x7F) ? (char)c : '.';
+        }
+#endif
+        *l++ = '\r';
+        *l++ = '\n';
+        o.len = (size_t)(l - out);
+    }
+
+    if (limit < size) {
+        out_mem(&o, "... ", 4);
+        out_number(&o, size - limit, 10, false, "", 0, 0, -1);
+        out_mem(&o, " more bytes\r\n", 13);
+    }
+    out[o.len] = '\0';
+    log_commit(terminal_id, level, "", out, o.len, 0, false);
+#if LOG_ENABLE_RECORD_POOL
+    if (out != fallback) {
+        pool_put(out);
+    }
+#endif
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+/* Hexdump                                                                */
+/* -------------------------------------------------------------------------- */
+void ulog_hexdump(const char *name, uint8_t width, const void *buf, size_t size)
+{
+    ulog_hexdump_ex(ULOG_RTT_TERMINAL_ID, 'D', name, width, buf, size);
+}
@@ -25,12 +25,342 @@ extern "C" {
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+
+#define ULOG_STR_(x)            #x
+#define ULOG_STR(x)             ULOG_STR_(x)
+#define ULOG_CAT_(a, b)         a##b
+#define ULOG_CAT(a, b)          ULOG_CAT_(a, b)
+
+/* 模块名自动作为标签：#define ULOG_MODULE UART -> ULOG_TAG "UART" */
+#if defined(ULOG_MODULE) && !defined(ULOG_TAG)
+#define ULOG_TAG                ULOG_STR(ULOG_MODULE)
+#endif
+
 #include "ulog_cfg.h"
 
 void ulog_init(void);
 void ulog_deinit(void);
-void ulog_hexdump(const char *name, uint8_t width, const void *buf, uint16_t size);
+void ulog_hexdump(const char *name, uint8_t width, const void *buf, size_t size);
+void ulog_hexdump_ex(unsigned char terminal_id, char level, const char *name,
+                     uint8_t width, const void *buf, size_t size);
 void ulog_output_ex(unsigned char terminal_id,char level, const char *tag,const char *fmt, ...);
+#if LOG_ENABLE_ASYNC || LOG_ENABLE_THREAD_SAFE
+void ulog_output_isr(unsigned char terminal_id, char level, const char *tag, const char *fmt, ...);
+#endif
+
+/* 由调用者渲染正文（ulog.hpp 使用）：级别判断通过后 render 把正文写入 buf，最多 size 个字符，
+ * 返回完整正文的长度（大于 size 表示被截断）；正文之后自动追加 "\r\n"。 */
+typedef size_t (*ulog_render_fn)(char *buf, size_t size, const void *ctx);
+void ulog_output_render(unsigned char terminal_id, char level, const char *tag,
+                        ulog_render_fn render, const void *ctx);
+
+/* -------------------------------------------------------------------------- */
+/* 运行时级别控制与过滤                                                       */
+/* -------------------------------------------------------------------------- */
+#define ULOG_LEVEL_INHERIT      0xFF    /* 标签未单独设置级别，跟随全局级别 */
+
+/* 判断指定级别、标签的日志当前是否会输出（不做任何格式化） */
+bool ulog_is_enabled(char level, const char *tag);
+
+#if LOG_ENABLE_RUNTIME_LEVEL_CONTROL
+void    ulog_set_level(uint8_t level);
+uint8_t ulog_get_level(void);
+bool    ulog_set_tag_level(const char *tag, uint8_t level);    /* level 可为 ULOG_LEVEL_INHERIT */
+uint8_t ulog_get_tag_level(const char *tag);
+#endif
+
+#if LOG_ENABLE_FILTER
+bool ulog_filter_add_tag(const char *tag);          /* 只输出包含这些标签的日志 */
+bool ulog_filter_add_keyword(const char *keyword);  /* 只输出包含这些关键词的日志 */
+void ulog_filter_clear(void);
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* 异步日志                                                                   */
+/* -------------------------------------------------------------------------- */
+#define ULOG_ASYNC_DROP_NEWEST  0   /* 缓冲区满时丢弃新日志 */
+#define ULOG_ASYNC_DROP_OLDEST  1   /* 缓冲区满时覆盖最旧日志 */
+#define ULOG_ASYNC_BLOCK        2   /* 缓冲区满时等待后台任务腾出空间 */
+
+typedef struct {
+    uint32_t written;           /* 成功写入缓冲区的记录数 */
+    uint32_t dropped;           /* 因缓冲区满被丢弃的新记录数 */
+    uint32_t overwritten;       /* DROP_OLDEST 策略下被覆盖的旧记录数 */
+    uint32_t dropped_error;     /* 中断中无法等待而丢弃的 ERROR/ASSERT 记录数 */
+} ulog_async_stats_t;
+
+/* 线程安全的同步模式下统计的是提交缓冲区 */
+#if LOG_ENABLE_ASYNC || LOG_ENABLE_THREAD_SAFE
+void ulog_async_get_stats(ulog_async_stats_t *stats);
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* 记录池                                                                     */
+/* -------------------------------------------------------------------------- */
+typedef struct {
+    uint32_t fallback;          /* 槽用完、退回栈缓冲区的次数 */
+    uint32_t peak;              /* 同时占用的最多槽数 */
+} ulog_pool_stats_t;
+
+#if LOG_ENABLE_RECORD_POOL
+void ulog_pool_get_stats(ulog_pool_stats_t *stats);
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* 时间戳                                                                     */
+/* -------------------------------------------------------------------------- */
+#define ULOG_TS_SOURCE_TICK         0   /* HAL_GetTick() */
+#define ULOG_TS_SOURCE_DWT          1   /* Cortex-M DWT->CYCCNT */
+#define ULOG_TS_SOURCE_MONOTONIC    2   /* clock_gettime(CLOCK_MONOTONIC) */
+#define ULOG_TS_SOURCE_USER         3   /* ulog_timestamp_source() */
+
+#if ULOG_WITH_TIMESTAMP || LOG_ENABLE_RATE_LIMIT || (LOG_ENABLE_STATS && LOG_STATS_DUMP_MS) || \
+    (LOG_PRINTF_BUFFERED && LOG_PRINTF_FLUSH_MS) || (LOG_ENABLE_METRIC && LOG_METRIC_PERIOD_MS)
+uint32_t ulog_get_timestamp(void);                      /* 毫秒 */
+uint64_t ulog_get_timestamp_us(void);                   /* 微秒 */
+#if (ULOG_TS_SOURCE == ULOG_TS_SOURCE_USER)
+void     ulog_timestamp_source(uint32_t *sec, uint32_t *usec);
+#endif
+#endif
+#if ULOG_WITH_TIMESTAMP
+void     ulog_get_timestamp_str(char *buf, size_t size);
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* 日志风暴保护                                                               */
+/* -------------------------------------------------------------------------- */
+/* ULOG_x_EVERY_MS / ULOG_x_THROTTLE 的调用点状态，由宏静态分配 */
+typedef struct {
+    uint32_t last;              /* 上次通过（EVERY_MS）或补充令牌（THROTTLE）的时间 (ms) */
+    uint32_t tokens;            /* THROTTLE 剩余令牌，单位 1/1000 条 */
+    bool     primed;
+} ulog_rate_t;
+
+#if LOG_ENABLE_RATE_LIMIT
+bool ulog_rate_every(ulog_rate_t *r, uint32_t ms);                     /* 距上次通过不少于 ms */
+bool ulog_rate_take(ulog_rate_t *r, uint32_t per_sec, uint32_t burst); /* 令牌桶 */
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* 日志统计                                                                   */
+/* -------------------------------------------------------------------------- */
+/* 按标签和调用点（文件:行）累计，计数器为 32 位、无锁累加，回绕后按差值使用。
+ * 耗时的单位取决于 LOG_STATS_CYCLES()：POSIX 默认为纳秒，未提供计数源时为 0。 */
+typedef struct {
+    uint32_t emitted;           /* 输出的条数 */
+    uint32_t suppressed;        /* 被级别、过滤器或限速宏拦下的条数 */
+    uint32_t bytes;             /* 输出的字节数（含前缀和时间戳） */
+    uint32_t fmt_cycles;        /* 格式化耗时累计 */
+    uint32_t out_cycles;        /* 提交和后端耗时累计 */
+} ulog_stats_t;
+
+/* 调用点状态，由输出宏静态分配；首次经过时登记到调用点链表 */
+typedef struct ulog_site ulog_site_t;
+struct ulog_site {
+    const char  *file;
+    uint32_t     line;
+    const char  *tag;           /* 以下由 ulog.c 维护 */
+    char         level;
+    uint8_t      linked;
+    ulog_site_t *next;
+    ulog_stats_t stats;
+};
+
+/* ulog_stats_foreach 的表项：标签汇总的 file 为 NULL、level 为 0 */
+typedef struct {
+    const char  *tag;
+    const char  *file;
+    uint32_t     line;
+    char         level;
+    ulog_stats_t stats;
+} ulog_stats_entry_t;
+
+#if LOG_ENABLE_STATS
+void ulog_output_site(ulog_site_t *site, unsigned char terminal_id, char level, const char *tag,
+                      const char *fmt, ...);
+void ulog_stats_suppress(ulog_site_t *site, char level, const char *tag);
+bool ulog_stats_get_tag(const char *tag, ulog_stats_t *stats);
+void ulog_stats_foreach(void (*fn)(const ulog_stats_entry_t *e, void *user), void *user); /* 先标签后调用点 */
+void ulog_stats_reset(void);
+void ulog_stats_dump(bool reset);   /* 以 [I/ULOG] 输出汇总，reset 为 true 时读出后清零 */
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* 指标聚合                                                                   */
+/* -------------------------------------------------------------------------- */
+/* 每个调用点一个静态 ulog_metric_t，更新只做无锁原子操作，可在中断中调用；每个周期
+ * 输出一行 "metric <name> n= min= max= mean= hist[lo,hi)=..." 并清零，本周期没有样本时不输出。
+ * 直方图把 [lo, hi) 等分为 LOG_METRIC_BUCKETS 个桶，越界的值计入首尾桶；hi <= lo 时不统计直方图。
+ * 没有 64 位无锁原子的平台上累加和为 32 位，一个周期内溢出时均值不准。 */
+#if LOG_ENABLE_METRIC
+#if defined(__GCC_ATOMIC_LLONG_LOCK_FREE) && (__GCC_ATOMIC_LLONG_LOCK_FREE == 2)
+typedef int64_t ulog_metric_sum_t;
+#else
+typedef int32_t ulog_metric_sum_t;
+#endif
+
+typedef struct ulog_metric ulog_metric_t;
+struct ulog_metric {
+    const char        *name;
+    int32_t            lo;
+    int32_t            hi;
+    uint32_t           width;       /* 桶宽，0 = 不统计直方图 */
+    const char        *tag;         /* 以下由 ulog.c 维护 */
+    char               level;
+    uint8_t            terminal;
+    uint8_t            linked;
+    ulog_metric_t     *next;
+    uint32_t           count;
+    int32_t            min;
+    int32_t            max;
+    ulog_metric_sum_t  sum;
+    uint32_t           hist[LOG_METRIC_BUCKETS];
+};
+
+void ulog_metric_update(ulog_metric_t *m, unsigned char terminal_id, char level, const char *tag,
+                        int32_t value);
+void ulog_metric_dump(void);    /* 输出各指标本周期的汇总并清零，不可在中断中调用 */
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* 飞行记录器                                                                 */
+/* -------------------------------------------------------------------------- */
+/* 级别低于 LOG_FLIGHT_LEVEL 的日志不格式化、不输出，只保存原始参数；
+ * ERROR/ASSERT 或 ulog_flight_flush() 时把之前的历史格式化后输出。 */
+typedef struct {
+    uint32_t captured;          /* 进入历史的条数 */
+    uint32_t flushed;           /* 已输出的条数 */
+    uint32_t lost;              /* 输出前被覆盖、或写入时槽被占用而丢弃的条数 */
+} ulog_flight_stats_t;
+
+#if LOG_ENABLE_FLIGHT
+void ulog_flight_flush(void);   /* 输出尚未输出的历史，不可在中断中调用 */
+void ulog_flight_clear(void);   /* 丢弃尚未输出的历史 */
+void ulog_flight_get_stats(ulog_flight_stats_t *stats);
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* 输出后端                                                                   */
+/* -------------------------------------------------------------------------- */
+/* 每条日志以分段形式一次交给后端：颜色、前缀（[E/TAG] 和时间戳）、正文、颜色复位。
+ * 未设置 ULOG_BACKEND_COLOR 的后端收到的颜色段长度为 0。 */
+#define ULOG_SEG_COLOR          0
+#define ULOG_SEG_PREFIX         1
+#define ULOG_SEG_BODY           2
+#define ULOG_SEG_RESET          3
+#define ULOG_SEG_COUNT          4
+
+#define ULOG_BACKEND_COLOR      0x01    /* 后端可以显示 ANSI 颜色 */
+
+typedef struct {
+    const char *ptr;
+    size_t      len;
+} ulog_seg_t;
+
+typedef struct ulog_backend ulog_backend_t;
+struct ulog_backend {
+    const char *name;
+    uint8_t     level;          /* 只接收不高于该级别的日志，RAW 输出不受限制 */
+    uint8_t     flags;          /* ULOG_BACKEND_xxx */
+    void      (*init)(ulog_backend_t *be);                  /* 可为 NULL */
+    void      (*write)(ulog_backend_t *be, unsigned char terminal, char level,
+                       const char *tag, const ulog_seg_t seg[ULOG_SEG_COUNT]);
+    void      (*flush)(ulog_backend_t *be);                 /* 可为 NULL */
+    void      (*deinit)(ulog_backend_t *be);                /* 可为 NULL */
+    void       *user;
+};
+
+/* 内置后端名为 "rtt" / "elog" / "printf"，可通过 ulog_backend_find 修改其级别 */
+bool            ulog_backend_register(ulog_backend_t *be);
+bool            ulog_backend_unregister(ulog_backend_t *be);
+ulog_backend_t *ulog_backend_find(const char *name);
+void            ulog_flush(void);
+
+/* -------------------------------------------------------------------------- */
+/* 文件后端（Linux/POSIX）                                                    */
+/* -------------------------------------------------------------------------- */
+#define ULOG_FILE_SYNC_NEVER    0   /* 只 write，由内核决定何时落盘 */
+#define ULOG_FILE_SYNC_ERROR    1   /* ERROR/ASSERT 写入后立即 fdatasync */
+#define ULOG_FILE_SYNC_PERIODIC 2   /* 每 LOG_FILE_SYNC_MS 毫秒 fdatasync 一次 */
+
+/* -------------------------------------------------------------------------- */
+/* printf 输出的缓冲模式                                                      */
+/* -------------------------------------------------------------------------- */
+/* 写出函数：把 buf 中 len 字节送到终端。允许在发送完成前返回（如启动 DMA），
+ * buf 保证在下一次调用前不被改写；buf 为 NULL 时须等待上一次发送完成（ulog_flush() 时调用）。
+ * 调用已由日志库串行化。fn 为 NULL 时恢复默认实现。 */
+#if LOG_PRINTF_BUFFERED
+typedef void (*ulog_write_fn)(const void *buf, size_t len);
+void ulog_printf_set_write(ulog_write_fn fn);
+#endif
+
+#if LOG_ENABLE_FILE
+extern ulog_backend_t ulog_backend_file;    /* 名为 "file"，默认已注册 */
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* 带索引的日志存储（Linux/POSIX）                                            */
+/* -------------------------------------------------------------------------- */
+#if LOG_ENABLE_STORE
+extern ulog_backend_t ulog_backend_store;   /* 名为 "store"，默认已注册 */
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* 共享内存环形缓冲区（Linux/POSIX）                                          */
+/* -------------------------------------------------------------------------- */
+/* 布局：ulog_shm_header_t 之后是 size 字节的数据区。位置均为累计字节数，
+ * 对 size 取模得到偏移；记录按 8 字节对齐，可以跨过数据区末尾。
+ * head / reserve / tail / seq 只由写入进程修改，读者须以原子操作读取：
+ * 拷贝一条记录之后再读 reserve，reserve - 读位置 > size 说明拷贝期间被覆盖。 */
+#define ULOG_SHM_MAGIC          0x4D48534Cu     /* "LSHM" */
+#define ULOG_SHM_VERSION        1
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;              /* 数据区大小，2 的幂 */
+    uint32_t pid;               /* 写入进程，变化说明写入方重启 */
+    uint64_t head;              /* 已发布的数据末尾 */
+    uint64_t reserve;           /* 正在写入的数据末尾 */
+    uint64_t tail;              /* 最旧一条完整记录的起点 */
+    uint64_t seq;               /* 下一条记录的序号 */
+    uint64_t reserved[2];
+} ulog_shm_header_t;
+
+typedef struct {
+    uint32_t size;              /* 记录字节数（含本头部，不含对齐填充） */
+    uint32_t seq;               /* 序号，读者据此发现丢失的记录 */
+    char     level;             /* 级别字符，0 为 RAW 输出 */
+    uint8_t  terminal;
+    uint8_t  tag_len;           /* 其后依次为标签、文本（前缀 + 正文） */
+    uint8_t  reserved;
+} ulog_shm_record_t;
+
+#if LOG_ENABLE_SHM
+extern ulog_backend_t ulog_backend_shm;     /* 名为 "shm"，默认已注册 */
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* syslog 网络后端（Linux/POSIX，RFC 5424 over UDP）                          */
+/* -------------------------------------------------------------------------- */
+#if LOG_ENABLE_NETWORK
+extern ulog_backend_t ulog_backend_syslog;  /* 名为 "syslog"，默认已注册 */
+bool     ulog_syslog_set_server(const char *host, uint16_t port);
+uint32_t ulog_syslog_get_dropped(void);     /* 因发送缓冲区满丢弃的报文数 */
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* 崩溃日志（复位后保留）                                                     */
+/* -------------------------------------------------------------------------- */
+#if LOG_ENABLE_CRASH_LOG
+size_t ulog_crash_found(void);              /* 上次运行异常终止时留下的字节数，0 表示没有 */
+size_t ulog_crash_read(char *buf, size_t size); /* 按时间顺序复制环形区内容，放不下时保留最新部分 */
+void   ulog_crash_clear(void);
+/* 由 ulog_init() / ulog_deinit() / 提交路径调用 */
+void   ulog_crash_init(void);
+void   ulog_crash_deinit(void);
+void   ulog_crash_record(const char *msg, size_t len);
+#endif
 
 /* -------------------------------------------------------------------------- */
 /* 日志输出方式宏定义                                                         */
@@ -50,6 +380,38 @@ void ulog_output_ex(unsigned char terminal_id,char level, const char *tag,const
 #define ULOG_LEVEL_DEBUG        4   /* 调试 */
 #define ULOG_LEVEL_VERBOSE      5   /* 最详细 */
 
+/* -------------------------------------------------------------------------- */
+/* 编译期级别阈值                                                             */
+/* -------------------------------------------------------------------------- */
+/* 本文件阈值：ULOG_LOCAL_LEVEL > LOG_LEVEL_<ULOG_MODULE> > ULOG_LEVEL
+ * 未定义的 LOG_LEVEL_<模块> 在 #if 中按 0（ASSERT）计算，会裁掉该文件的全部日志；
+ * 因此先把它的值拼接成 ULOG_LEVEL_SET_<值>，只有值为 0~5 时才采用，表中没有的模块
+ * （包括拼错的模块名）使用 ULOG_LEVEL。 */
+#define ULOG_LEVEL_SET_0        1
+#define ULOG_LEVEL_SET_1        1
+#define ULOG_LEVEL_SET_2        1
+#define ULOG_LEVEL_SET_3        1
+#define ULOG_LEVEL_SET_4        1
+#define ULOG_LEVEL_SET_5        1
+#ifndef ULOG_LOCAL_LEVEL
+  #if LOG_MODULE_LEVELS && defined(ULOG_MODULE)
+    #if ULOG_CAT(ULOG_LEVEL_SET_, ULOG_CAT(LOG_LEVEL_, ULOG_MODULE))
+      #define ULOG_LOCAL_LEVEL  ULOG_CAT(LOG_LEVEL_, ULOG_MODULE)
+    #else
+      #define ULOG_LOCAL_LEVEL  ULOG_LEVEL
+    #endif
+  #else
+    #define ULOG_LOCAL_LEVEL    ULOG_LEVEL
+  #endif
+#endif
+
+/* 实际生效的阈值，模块阈值不能高于全局阈值 */
+#if (ULOG_LOCAL_LEVEL < ULOG_LEVEL)
+  #define ULOG_STATIC_LEVEL     ULOG_LOCAL_LEVEL
+#else
+  #define ULOG_STATIC_LEVEL     ULOG_LEVEL
+#endif
+
 #ifndef ULOG_COLOR_ENABLE
 #define ULOG_COLOR_ENABLE       1   /* 默认启用彩色输出 */
 #endif
@@ -140,77 +502,420 @@ void ulog_output_ex(unsigned char terminal_id,char level, const char *tag,const
 
 
 /* -------------------------------------------------------------------------- */
-/* 宏封装：快速输出日志                                                       */
+/* 二进制日志（延迟格式化）                                                   */
 /* -------------------------------------------------------------------------- */
-/* 默认使用 ULOG_TAG 和 ULOG_RTT_TERMINAL_ID */
-#if ULOG_OUTPUT_DISABLE
-    #define ULOG_A(fmt, ...) ((void)0)
-    #define ULOG_E(fmt, ...) ((void)0)
-    #define ULOG_W(fmt, ...) ((void)0)
-    #define ULOG_I(fmt, ...) ((void)0)
-    #define ULOG_D(fmt, ...) ((void)0)
-    #define ULOG_V(fmt, ...) ((void)0)
+/* 调用点只输出 "级别+标签\0格式串" 在 ulog_fmt 段中的偏移、时间戳和原始参数，
+ * 由主机端 tools/ulog_decode.py 结合 ELF 还原为文本。标签须为字符串字面量。 */
+#if LOG_ENABLE_BINARY
+void ulog_bin_output(unsigned char terminal_id, const char *entry, ...);
+
+	#define ULOG_BIN_SECTION    __attribute__((section("ulog_fmt"), used))
+	#define ULOG_BIN_OUT(lv, tid, tag, fmt, ...) do {                                   \
+		static const char ULOG_BIN_SECTION ulog_entry_[] = lv tag "\0" fmt;             \
+		ulog_bin_output(tid, ulog_entry_, ##__VA_ARGS__);                              \
+	} while (0)
+	#define ULOG_EMIT(lv, tid, tag, fmt, ...) ULOG_BIN_OUT(#lv, tid, tag, fmt, ##__VA_ARGS__)
+#elif LOG_ENABLE_STATS
+	#define ULOG_EMIT(lv, tid, tag, fmt, ...) do {                                      \
+		ULOG_SITE_DEF();                                                              \
+		ULOG_SITE_OUT(lv, tid, tag, fmt, ##__VA_ARGS__);                              \
+	} while (0)
 #else
-	#define ULOG_A(fmt, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'A', ULOG_TAG, fmt, ##__VA_ARGS__)
-	#define ULOG_E(fmt, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'E', ULOG_TAG, fmt, ##__VA_ARGS__)
-	#define ULOG_W(fmt, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'W', ULOG_TAG, fmt, ##__VA_ARGS__)
-	#define ULOG_I(fmt, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'I', ULOG_TAG, fmt, ##__VA_ARGS__)
-	#define ULOG_D(fmt, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'D', ULOG_TAG, fmt, ##__VA_ARGS__)
-	#define ULOG_V(fmt, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'V', ULOG_TAG, fmt, ##__VA_ARGS__)
+	#define ULOG_EMIT(lv, tid, tag, fmt, ...) ulog_output_ex(tid, #lv[0], tag, fmt, ##__VA_ARGS__)
 #endif
 
-/* 指定标签 */
-#if ULOG_OUTPUT_DISABLE
-    #define ULOG_A_TAG(tag, format, ...) ((void)0)
-    #define ULOG_E_TAG(tag, format, ...) ((void)0)
-    #define ULOG_W_TAG(tag, format, ...) ((void)0)
-    #define ULOG_I_TAG(tag, format, ...) ((void)0)
-    #define ULOG_D_TAG(tag, format, ...) ((void)0)
-    #define ULOG_V_TAG(tag, format, ...) ((void)0)
+/* 日志统计的调用点：每个调用点一个静态 ulog_site_t，限速宏被抑制的调用也记在同一调用点上。
+ * 二进制日志只按标签统计；未开启统计时展开为空。 */
+#if LOG_ENABLE_STATS && !LOG_ENABLE_BINARY
+	#define ULOG_SITE_DEF()                                                           \
+		static ulog_site_t ulog_site_ = { __FILE__, __LINE__, NULL, 0, 0, NULL, { 0, 0, 0, 0, 0 } }
+	#define ULOG_SITE_OUT(lv, tid, tag, fmt, ...)                                     \
+		ulog_output_site(&ulog_site_, tid, #lv[0], tag, fmt, ##__VA_ARGS__)
+	#define ULOG_SITE_SKIP(lv, tag) ulog_stats_suppress(&ulog_site_, #lv[0], tag)
+#elif LOG_ENABLE_STATS
+	#define ULOG_SITE_DEF()         ((void)0)
+	#define ULOG_SITE_OUT(lv, tid, tag, fmt, ...) ULOG_OUT_##lv(tid, tag, fmt, ##__VA_ARGS__)
+	#define ULOG_SITE_SKIP(lv, tag) ulog_stats_suppress(NULL, #lv[0], tag)
 #else
-    #define ULOG_A_TAG(tag, format, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'A', tag, format, ##__VA_ARGS__)
-    #define ULOG_E_TAG(tag, format, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'E', tag, format, ##__VA_ARGS__)
-    #define ULOG_W_TAG(tag, format, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'W', tag, format, ##__VA_ARGS__)
-    #define ULOG_I_TAG(tag, format, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'I', tag, format, ##__VA_ARGS__)
-    #define ULOG_D_TAG(tag, format, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'D', tag, format, ##__VA_ARGS__)
-    #define ULOG_V_TAG(tag, format, ...) 	ulog_output_ex(ULOG_RTT_TERMINAL_ID, 'V', tag, format, ##__VA_ARGS__)
+	#define ULOG_SITE_DEF()         ((void)0)
+	#define ULOG_SITE_OUT(lv, tid, tag, fmt, ...) ULOG_OUT_##lv(tid, tag, fmt, ##__VA_ARGS__)
+	#define ULOG_SITE_SKIP(lv, tag) ((void)0)
 #endif
 
-/* 指定终端 */
-#if ULOG_OUTPUT_DISABLE
-    #define ULOG_A_T(tid, fmt, ...) ((void)0)
-    #define ULOG_E_T(tid, fmt, ...) ((void)0)
-    #define ULOG_W_T(tid, fmt, ...) ((void)0)
-    #define ULOG_I_T(tid, fmt, ...) ((void)0)
-    #define ULOG_D_T(tid, fmt, ...) ((void)0)
-    #define ULOG_V_T(tid, fmt, ...) ((void)0)
+/* -------------------------------------------------------------------------- */
+/* 按级别裁剪的输出宏：低于 ULOG_STATIC_LEVEL 的级别展开为空                  */
+/* -------------------------------------------------------------------------- */
+#if !ULOG_OUTPUT_DISABLE && (ULOG_STATIC_LEVEL >= ULOG_LEVEL_ASSERT)
+	#define ULOG_OUT_A(tid, tag, fmt, ...) ULOG_EMIT(A, tid, tag, fmt, ##__VA_ARGS__)
+#else
+	#define ULOG_OUT_A(tid, tag, fmt, ...) ((void)0)
+#endif
+#if !ULOG_OUTPUT_DISABLE && (ULOG_STATIC_LEVEL >= ULOG_LEVEL_ERROR)
+	#define ULOG_OUT_E(tid, tag, fmt, ...) ULOG_EMIT(E, tid, tag, fmt, ##__VA_ARGS__)
+#else
+	#define ULOG_OUT_E(tid, tag, fmt, ...) ((void)0)
+#endif
+#if !ULOG_OUTPUT_DISABLE && (ULOG_STATIC_LEVEL >= ULOG_LEVEL_WARN)
+	#define ULOG_OUT_W(tid, tag, fmt, ...) ULOG_EMIT(W, tid, tag, fmt, ##__VA_ARGS__)
+#else
+	#define ULOG_OUT_W(tid, tag, fmt, ...) ((void)0)
+#endif
+#if !ULOG_OUTPUT_DISABLE && (ULOG_STATIC_LEVEL >= ULOG_LEVEL_INFO)
+	#define ULOG_OUT_I(tid, tag, fmt, ...) ULOG_EMIT(I, tid, tag, fmt, ##__VA_ARGS__)
+#else
+	#define ULOG_OUT_I(tid, tag, fmt, ...) ((void)0)
+#endif
+#if !ULOG_OUTPUT_DISABLE && (ULOG_STATIC_LEVEL >= ULOG_LEVEL_DEBUG)
+	#define ULOG_OUT_D(tid, tag, fmt, ...) ULOG_EMIT(D, tid, tag, fmt, ##__VA_ARGS__)
 #else
-	#define ULOG_A_T(tid, fmt, ...) ulog_output_ex(tid, 'A', ULOG_TAG, fmt, ##__VA_ARGS__)
-	#define ULOG_E_T(tid, fmt, ...) ulog_output_ex(tid, 'E', ULOG_TAG, fmt, ##__VA_ARGS__)
-	#define ULOG_W_T(tid, fmt, ...) ulog_output_ex(tid, 'W', ULOG_TAG, fmt, ##__VA_ARGS__)
-	#define ULOG_I_T(tid, fmt, ...) ulog_output_ex(tid, 'I', ULOG_TAG, fmt, ##__VA_ARGS__)
-	#define ULOG_D_T(tid, fmt, ...) ulog_output_ex(tid, 'D', ULOG_TAG, fmt, ##__VA_ARGS__)
-	#define ULOG_V_T(tid, fmt, ...) ulog_output_ex(tid, 'V', ULOG_TAG, fmt, ##__VA_ARGS__)
+	#define ULOG_OUT_D(tid, tag, fmt, ...) ((void)0)
+#endif
+#if !ULOG_OUTPUT_DISABLE && (ULOG_STATIC_LEVEL >= ULOG_LEVEL_VERBOSE)
+	#define ULOG_OUT_V(tid, tag, fmt, ...) ULOG_EMIT(V, tid, tag, fmt, ##__VA_ARGS__)
+#else
+	#define ULOG_OUT_V(tid, tag, fmt, ...) ((void)0)
 #endif
 
+/* -------------------------------------------------------------------------- */
+/* 宏封装：快速输出日志                                                       */
+/* -------------------------------------------------------------------------- */
+/* 默认使用 ULOG_TAG 和 ULOG_RTT_TERMINAL_ID */
+#define ULOG_A(fmt, ...) 	ULOG_OUT_A(ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_E(fmt, ...) 	ULOG_OUT_E(ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_W(fmt, ...) 	ULOG_OUT_W(ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_I(fmt, ...) 	ULOG_OUT_I(ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_D(fmt, ...) 	ULOG_OUT_D(ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_V(fmt, ...) 	ULOG_OUT_V(ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+
+/* 指定标签 */
+#define ULOG_A_TAG(tag, format, ...) 	ULOG_OUT_A(ULOG_RTT_TERMINAL_ID, tag, format, ##__VA_ARGS__)
+#define ULOG_E_TAG(tag, format, ...) 	ULOG_OUT_E(ULOG_RTT_TERMINAL_ID, tag, format, ##__VA_ARGS__)
+#define ULOG_W_TAG(tag, format, ...) 	ULOG_OUT_W(ULOG_RTT_TERMINAL_ID, tag, format, ##__VA_ARGS__)
+#define ULOG_I_TAG(tag, format, ...) 	ULOG_OUT_I(ULOG_RTT_TERMINAL_ID, tag, format, ##__VA_ARGS__)
+#define ULOG_D_TAG(tag, format, ...) 	ULOG_OUT_D(ULOG_RTT_TERMINAL_ID, tag, format, ##__VA_ARGS__)
+#define ULOG_V_TAG(tag, format, ...) 	ULOG_OUT_V(ULOG_RTT_TERMINAL_ID, tag, format, ##__VA_ARGS__)
+
+/* 指定终端 */
+#define ULOG_A_T(tid, fmt, ...) ULOG_OUT_A(tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_E_T(tid, fmt, ...) ULOG_OUT_E(tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_W_T(tid, fmt, ...) ULOG_OUT_W(tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_I_T(tid, fmt, ...) ULOG_OUT_I(tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_D_T(tid, fmt, ...) ULOG_OUT_D(tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_V_T(tid, fmt, ...) ULOG_OUT_V(tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+
 
 /* 指定终端+标签 */
+#define ULOG_A_TT(tid, tag, fmt, ...) ULOG_OUT_A(tid, tag, fmt, ##__VA_ARGS__)
+#define ULOG_E_TT(tid, tag, fmt, ...) ULOG_OUT_E(tid, tag, fmt, ##__VA_ARGS__)
+#define ULOG_W_TT(tid, tag, fmt, ...) ULOG_OUT_W(tid, tag, fmt, ##__VA_ARGS__)
+#define ULOG_I_TT(tid, tag, fmt, ...) ULOG_OUT_I(tid, tag, fmt, ##__VA_ARGS__)
+#define ULOG_D_TT(tid, tag, fmt, ...) ULOG_OUT_D(tid, tag, fmt, ##__VA_ARGS__)
+#define ULOG_V_TT(tid, tag, fmt, ...) ULOG_OUT_V(tid, tag, fmt, ##__VA_ARGS__)
+
+/* 中断上下文：执行时间有上限，从不等待，也不在中断中调用后端。
+ * 记录要暂存在提交缓冲区中，需开启 LOG_ENABLE_ASYNC 或 LOG_ENABLE_THREAD_SAFE */
 #if ULOG_OUTPUT_DISABLE
-    #define ULOG_A_TT(tid, tag, fmt, ...) ((void)0)
-    #define ULOG_E_TT(tid, tag, fmt, ...) ((void)0)
-    #define ULOG_W_TT(tid, tag, fmt, ...) ((void)0)
-    #define ULOG_I_TT(tid, tag, fmt, ...) ((void)0)
-    #define ULOG_D_TT(tid, tag, fmt, ...) ((void)0)
-    #define ULOG_V_TT(tid, tag, fmt, ...) ((void)0)
+#define ULOG_ISR_EMIT(lvl, lv, fmt, ...) do { } while (0)
+#elif LOG_ENABLE_ASYNC || LOG_ENABLE_THREAD_SAFE
+#define ULOG_ISR_EMIT(lvl, lv, fmt, ...) do {                                       \
+		if (ULOG_STATIC_LEVEL >= (lvl))                                               \
+			ulog_output_isr(ULOG_RTT_TERMINAL_ID, lv, ULOG_TAG, fmt, ##__VA_ARGS__);  \
+	} while (0)
+#elif defined(__cplusplus)
+#define ULOG_ISR_EMIT(lvl, lv, fmt, ...) \
+	static_assert((lvl) < 0, "ULOG_x_ISR requires LOG_ENABLE_ASYNC or LOG_ENABLE_THREAD_SAFE")
 #else
-	#define ULOG_A_TT(tid, tag, fmt, ...) ulog_output_ex(tid, 'A', tag, fmt, ##__VA_ARGS__)
-	#define ULOG_E_TT(tid, tag, fmt, ...) ulog_output_ex(tid, 'E', tag, fmt, ##__VA_ARGS__)
-	#define ULOG_W_TT(tid, tag, fmt, ...) ulog_output_ex(tid, 'W', tag, fmt, ##__VA_ARGS__)
-	#define ULOG_I_TT(tid, tag, fmt, ...) ulog_output_ex(tid, 'I', tag, fmt, ##__VA_ARGS__)
-	#define ULOG_D_TT(tid, tag, fmt, ...) ulog_output_ex(tid, 'D', tag, fmt, ##__VA_ARGS__)
-	#define ULOG_V_TT(tid, tag, fmt, ...) ulog_output_ex(tid, 'V', tag, fmt, ##__VA_ARGS__)
+#define ULOG_ISR_EMIT(lvl, lv, fmt, ...) \
+	_Static_assert((lvl) < 0, "ULOG_x_ISR requires LOG_ENABLE_ASYNC or LOG_ENABLE_THREAD_SAFE")
+#endif
+#define ULOG_A_ISR(fmt, ...) ULOG_ISR_EMIT(ULOG_LEVEL_ASSERT, 'A', fmt, ##__VA_ARGS__)
+#define ULOG_E_ISR(fmt, ...) ULOG_ISR_EMIT(ULOG_LEVEL_ERROR, 'E', fmt, ##__VA_ARGS__)
+#define ULOG_W_ISR(fmt, ...) ULOG_ISR_EMIT(ULOG_LEVEL_WARN, 'W', fmt, ##__VA_ARGS__)
+#define ULOG_I_ISR(fmt, ...) ULOG_ISR_EMIT(ULOG_LEVEL_INFO, 'I', fmt, ##__VA_ARGS__)
+#define ULOG_D_ISR(fmt, ...) ULOG_ISR_EMIT(ULOG_LEVEL_DEBUG, 'D', fmt, ##__VA_ARGS__)
+#define ULOG_V_ISR(fmt, ...) ULOG_ISR_EMIT(ULOG_LEVEL_VERBOSE, 'V', fmt, ##__VA_ARGS__)
+
+/* 按调用点限制输出次数，每个调用点有自己的静态状态，被抑制时不格式化、不调用后端。
+ * 状态不加锁，多个任务同时经过同一调用点时可能多输出一条。
+ *   ULOG_E_ONCE(fmt, ...)                       只输出第一次
+ *   ULOG_E_EVERY_N(n, fmt, ...)                 第 1、n+1、2n+1 ... 次输出（n >= 1）
+ *   ULOG_E_EVERY_MS(ms, fmt, ...)               两次输出至少间隔 ms 毫秒
+ *   ULOG_E_THROTTLE(per_sec, burst, fmt, ...)   令牌桶：平均每秒 per_sec 条，最多连续 burst 条
+ * 后两者需要 LOG_ENABLE_RATE_LIMIT。与 ULOG_x_TAG / ULOG_x_T 对应，各自另有指定标签、指定终端的版本，
+ * 标签或终端号作为第一个参数：ULOG_E_ONCE_TAG(tag, fmt, ...)、ULOG_W_EVERY_MS_T(tid, ms, fmt, ...)。 */
+#define ULOG_LIMIT_ON(lvl)      (!ULOG_OUTPUT_DISABLE && ULOG_STATIC_LEVEL >= (lvl))
+
+#define ULOG_ONCE_(lvl, lv, tid, tag, fmt, ...) do {                                \
+		static bool ulog_once_;                                                       \
+		ULOG_SITE_DEF();                                                              \
+		if (!ULOG_LIMIT_ON(lvl)) {                                                    \
+		} else if (!ulog_once_) {                                                     \
+			ulog_once_ = true;                                                        \
+			ULOG_SITE_OUT(lv, tid, tag, fmt, ##__VA_ARGS__);                          \
+		} else {                                                                      \
+			ULOG_SITE_SKIP(lv, tag);                                                  \
+		}                                                                             \
+	} while (0)
+#define ULOG_EVERY_N_(lvl, lv, tid, tag, n, fmt, ...) do {                          \
+		static uint32_t ulog_skip_;                                                   \
+		ULOG_SITE_DEF();                                                              \
+		if (!ULOG_LIMIT_ON(lvl)) {                                                    \
+		} else if (ulog_skip_-- == 0) {                                               \
+			ulog_skip_ = (uint32_t)(n) - 1;                                           \
+			ULOG_SITE_OUT(lv, tid, tag, fmt, ##__VA_ARGS__);                          \
+		} else {                                                                      \
+			ULOG_SITE_SKIP(lv, tag);                                                  \
+		}                                                                             \
+	} while (0)
+#define ULOG_EVERY_MS_(lvl, lv, tid, tag, ms, fmt, ...) do {                        \
+		static ulog_rate_t ulog_rate_;                                                \
+		ULOG_SITE_DEF();                                                              \
+		if (!ULOG_LIMIT_ON(lvl)) {                                                    \
+		} else if (ulog_rate_every(&ulog_rate_, (ms))) {                              \
+			ULOG_SITE_OUT(lv, tid, tag, fmt, ##__VA_ARGS__);                          \
+		} else {                                                                      \
+			ULOG_SITE_SKIP(lv, tag);                                                  \
+		}                                                                             \
+	} while (0)
+#define ULOG_THROTTLE_(lvl, lv, tid, tag, per_sec, burst, fmt, ...) do {            \
+		static ulog_rate_t ulog_rate_;                                                \
+		ULOG_SITE_DEF();                                                              \
+		if (!ULOG_LIMIT_ON(lvl)) {                                                    \
+		} else if (ulog_rate_take(&ulog_rate_, (per_sec), (burst))) {                 \
+			ULOG_SITE_OUT(lv, tid, tag, fmt, ##__VA_ARGS__);                          \
+		} else {                                                                      \
+			ULOG_SITE_SKIP(lv, tag);                                                  \
+		}                                                                             \
+	} while (0)
+
+#define ULOG_A_ONCE(fmt, ...) ULOG_ONCE_(ULOG_LEVEL_ASSERT, A, ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_E_ONCE(fmt, ...) ULOG_ONCE_(ULOG_LEVEL_ERROR, E, ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_W_ONCE(fmt, ...) ULOG_ONCE_(ULOG_LEVEL_WARN, W, ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_I_ONCE(fmt, ...) ULOG_ONCE_(ULOG_LEVEL_INFO, I, ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_D_ONCE(fmt, ...) ULOG_ONCE_(ULOG_LEVEL_DEBUG, D, ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_V_ONCE(fmt, ...) ULOG_ONCE_(ULOG_LEVEL_VERBOSE, V, ULOG_RTT_TERMINAL_ID, ULOG_TAG, fmt, ##__VA_ARGS__)
+
+#define ULOG_A_ONCE_TAG(tag, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_ASSERT, A, ULOG_RTT_TERMINAL_ID, tag, fmt, ##__VA_ARGS__)
+#define ULOG_E_ONCE_TAG(tag, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_ERROR, E, ULOG_RTT_TERMINAL_ID, tag, fmt, ##__VA_ARGS__)
+#define ULOG_W_ONCE_TAG(tag, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_WARN, W, ULOG_RTT_TERMINAL_ID, tag, fmt, ##__VA_ARGS__)
+#define ULOG_I_ONCE_TAG(tag, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_INFO, I, ULOG_RTT_TERMINAL_ID, tag, fmt, ##__VA_ARGS__)
+#define ULOG_D_ONCE_TAG(tag, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_DEBUG, D, ULOG_RTT_TERMINAL_ID, tag, fmt, ##__VA_ARGS__)
+#define ULOG_V_ONCE_TAG(tag, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_VERBOSE, V, ULOG_RTT_TERMINAL_ID, tag, fmt, ##__VA_ARGS__)
+
+#define ULOG_A_ONCE_T(tid, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_ASSERT, A, tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_E_ONCE_T(tid, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_ERROR, E, tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_W_ONCE_T(tid, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_WARN, W, tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_I_ONCE_T(tid, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_INFO, I, tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_D_ONCE_T(tid, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_DEBUG, D, tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+#define ULOG_V_ONCE_T(tid, fmt, ...) ULOG_ONCE_(ULOG_LEVEL_VERBOSE, V, tid, ULOG_TAG, fmt, ##__VA_ARGS__)
+
+#define ULOG_A_EVERY_N(n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_ASSERT, A, ULOG_RTT_TERMINAL_ID, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+#define ULOG_E_EVERY_N(n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_ERROR, E, ULOG_RTT_TERMINAL_ID, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+#define ULOG_W_EVERY_N(n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_WARN, W, ULOG_RTT_TERMINAL_ID, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+#define ULOG_I_EVERY_N(n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_INFO, I, ULOG_RTT_TERMINAL_ID, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+#define ULOG_D_EVERY_N(n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_DEBUG, D, ULOG_RTT_TERMINAL_ID, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+#define ULOG_V_EVERY_N(n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_VERBOSE, V, ULOG_RTT_TERMINAL_ID, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+
+#define ULOG_A_EVERY_N_TAG(tag, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_ASSERT, A, ULOG_RTT_TERMINAL_ID, tag, n, fmt, ##__VA_ARGS__)
+#define ULOG_E_EVERY_N_TAG(tag, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_ERROR, E, ULOG_RTT_TERMINAL_ID, tag, n, fmt, ##__VA_ARGS__)
+#define ULOG_W_EVERY_N_TAG(tag, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_WARN, W, ULOG_RTT_TERMINAL_ID, tag, n, fmt, ##__VA_ARGS__)
+#define ULOG_I_EVERY_N_TAG(tag, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_INFO, I, ULOG_RTT_TERMINAL_ID, tag, n, fmt, ##__VA_ARGS__)
+#define ULOG_D_EVERY_N_TAG(tag, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_DEBUG, D, ULOG_RTT_TERMINAL_ID, tag, n, fmt, ##__VA_ARGS__)
+#define ULOG_V_EVERY_N_TAG(tag, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_VERBOSE, V, ULOG_RTT_TERMINAL_ID, tag, n, fmt, ##__VA_ARGS__)
+
+#define ULOG_A_EVERY_N_T(tid, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_ASSERT, A, tid, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+#define ULOG_E_EVERY_N_T(tid, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_ERROR, E, tid, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+#define ULOG_W_EVERY_N_T(tid, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_WARN, W, tid, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+#define ULOG_I_EVERY_N_T(tid, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_INFO, I, tid, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+#define ULOG_D_EVERY_N_T(tid, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_DEBUG, D, tid, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+#define ULOG_V_EVERY_N_T(tid, n, fmt, ...) ULOG_EVERY_N_(ULOG_LEVEL_VERBOSE, V, tid, ULOG_TAG, n, fmt, ##__VA_ARGS__)
+
+#if LOG_ENABLE_RATE_LIMIT
+#define ULOG_A_EVERY_MS(ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_ASSERT, A, ULOG_RTT_TERMINAL_ID, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+#define ULOG_E_EVERY_MS(ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_ERROR, E, ULOG_RTT_TERMINAL_ID, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+#define ULOG_W_EVERY_MS(ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_WARN, W, ULOG_RTT_TERMINAL_ID, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+#define ULOG_I_EVERY_MS(ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_INFO, I, ULOG_RTT_TERMINAL_ID, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+#define ULOG_D_EVERY_MS(ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_DEBUG, D, ULOG_RTT_TERMINAL_ID, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+#define ULOG_V_EVERY_MS(ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_VERBOSE, V, ULOG_RTT_TERMINAL_ID, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+
+#define ULOG_A_EVERY_MS_TAG(tag, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_ASSERT, A, ULOG_RTT_TERMINAL_ID, tag, ms, fmt, ##__VA_ARGS__)
+#define ULOG_E_EVERY_MS_TAG(tag, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_ERROR, E, ULOG_RTT_TERMINAL_ID, tag, ms, fmt, ##__VA_ARGS__)
+#define ULOG_W_EVERY_MS_TAG(tag, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_WARN, W, ULOG_RTT_TERMINAL_ID, tag, ms, fmt, ##__VA_ARGS__)
+#define ULOG_I_EVERY_MS_TAG(tag, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_INFO, I, ULOG_RTT_TERMINAL_ID, tag, ms, fmt, ##__VA_ARGS__)
+#define ULOG_D_EVERY_MS_TAG(tag, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_DEBUG, D, ULOG_RTT_TERMINAL_ID, tag, ms, fmt, ##__VA_ARGS__)
+#define ULOG_V_EVERY_MS_TAG(tag, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_VERBOSE, V, ULOG_RTT_TERMINAL_ID, tag, ms, fmt, ##__VA_ARGS__)
+
+#define ULOG_A_EVERY_MS_T(tid, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_ASSERT, A, tid, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+#define ULOG_E_EVERY_MS_T(tid, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_ERROR, E, tid, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+#define ULOG_W_EVERY_MS_T(tid, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_WARN, W, tid, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+#define ULOG_I_EVERY_MS_T(tid, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_INFO, I, tid, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+#define ULOG_D_EVERY_MS_T(tid, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_DEBUG, D, tid, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+#define ULOG_V_EVERY_MS_T(tid, ms, fmt, ...) ULOG_EVERY_MS_(ULOG_LEVEL_VERBOSE, V, tid, ULOG_TAG, ms, fmt, ##__VA_ARGS__)
+
+#define ULOG_A_THROTTLE(per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_ASSERT, A, ULOG_RTT_TERMINAL_ID, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_E_THROTTLE(per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_ERROR, E, ULOG_RTT_TERMINAL_ID, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_W_THROTTLE(per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_WARN, W, ULOG_RTT_TERMINAL_ID, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_I_THROTTLE(per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_INFO, I, ULOG_RTT_TERMINAL_ID, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_D_THROTTLE(per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_DEBUG, D, ULOG_RTT_TERMINAL_ID, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_V_THROTTLE(per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_VERBOSE, V, ULOG_RTT_TERMINAL_ID, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
+
+#define ULOG_A_THROTTLE_TAG(tag, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_ASSERT, A, ULOG_RTT_TERMINAL_ID, tag, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_E_THROTTLE_TAG(tag, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_ERROR, E, ULOG_RTT_TERMINAL_ID, tag, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_W_THROTTLE_TAG(tag, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_WARN, W, ULOG_RTT_TERMINAL_ID, tag, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_I_THROTTLE_TAG(tag, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_INFO, I, ULOG_RTT_TERMINAL_ID, tag, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_D_THROTTLE_TAG(tag, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_DEBUG, D, ULOG_RTT_TERMINAL_ID, tag, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_V_THROTTLE_TAG(tag, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_VERBOSE, V, ULOG_RTT_TERMINAL_ID, tag, per_sec, burst, fmt, ##__VA_ARGS__)
+
+#define ULOG_A_THROTTLE_T(tid, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_ASSERT, A, tid, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_E_THROTTLE_T(tid, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_ERROR, E, tid, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_W_THROTTLE_T(tid, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_WARN, W, tid, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_I_THROTTLE_T(tid, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_INFO, I, tid, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_D_THROTTLE_T(tid, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_DEBUG, D, tid, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
+#define ULOG_V_THROTTLE_T(tid, per_sec, burst, fmt, ...) ULOG_THROTTLE_(ULOG_LEVEL_VERBOSE, V, tid, ULOG_TAG, per_sec, burst, fmt, ##__VA_ARGS__)
 #endif
 
+/* -------------------------------------------------------------------------- */
+/* 结构化日志（键值对）                                                       */
+/* -------------------------------------------------------------------------- */
+/* ULOG_KV_I("motor stalled", ULOG_KV("rpm", rpm), ULOG_KV("phase", "B"));
+ * 值的类型在编译期确定（C 用 _Generic，C++ 用重载/模板），运行时不解析格式串。
+ * ULOG_KV_JSON：正文为 {"msg":"motor stalled","rpm":1200,"phase":"B"}，与普通日志一样
+ *               带 [I/TAG] 前缀和时间戳，经提交缓冲区和各后端输出；
+ * ULOG_KV_TLV ：紧凑二进制帧，与二进制日志一样直接写入 RTT 通道 / stdout，
+ *               由 tools/ulog_decode.py 还原为 JSON 行。
+ * 至少需要一个键值对；键和字符串值只在调用期间被读取。 */
+#define ULOG_KV_JSON            0
+#define ULOG_KV_TLV             1
+
+#define ULOG_KV_T_BOOL          0
+#define ULOG_KV_T_INT           1
+#define ULOG_KV_T_UINT          2
+#define ULOG_KV_T_FLOAT         3
+#define ULOG_KV_T_STR           4
+#define ULOG_KV_T_BYTES         5
+
+#if LOG_ENABLE_KV
+typedef struct {
+    const char *key;
+    uint8_t     type;           /* ULOG_KV_T_xxx */
+    uint16_t    len;            /* ULOG_KV_T_BYTES 的字节数 */
+    union {
+        int64_t     i;
+        uint64_t    u;
+        double      f;
+        const char *s;
+        const void *p;
+    } v;
+} ulog_kv_t;
+
+void ulog_kv_output(unsigned char terminal_id, char level, const char *tag,
+                    const char *msg, const ulog_kv_t *kv, size_t count);
+
+static inline ulog_kv_t ulog_kv_bool(const char *key, bool val)
+{
+    ulog_kv_t kv;
+    kv.key = key; kv.type = ULOG_KV_T_BOOL; kv.len = 0; kv.v.i = val ? 1 : 0;
+    return kv;
+}
+static inline ulog_kv_t ulog_kv_int(const char *key, int64_t val)
+{
+    ulog_kv_t kv;
+    kv.key = key; kv.type = ULOG_KV_T_INT; kv.len = 0; kv.v.i = val;
+    return kv;
+}
+static inline ulog_kv_t ulog_kv_uint(const char *key, uint64_t val)
+{
+    ulog_kv_t kv;
+    kv.key = key; kv.type = ULOG_KV_T_UINT; kv.len = 0; kv.v.u = val;
+    return kv;
+}
+static inline ulog_kv_t ulog_kv_float(const char *key, double val)
+{
+    ulog_kv_t kv;
+    kv.key = key; kv.type = ULOG_KV_T_FLOAT; kv.len = 0; kv.v.f = val;
+    return kv;
+}
+static inline ulog_kv_t ulog_kv_str(const char *key, const char *val)
+{
+    ulog_kv_t kv;
+    kv.key = key; kv.type = ULOG_KV_T_STR; kv.len = 0; kv.v.s = val;
+    return kv;
+}
+static inline ulog_kv_t ulog_kv_bytes(const char *key, const void *buf, size_t size)
+{
+    ulog_kv_t kv;
+    kv.key = key; kv.type = ULOG_KV_T_BYTES; kv.len = (uint16_t)(size > 0xFFFF ? 0xFFFF : size); kv.v.p = buf;
+    return kv;
+}
+
+/* 按值的类型选择编码；不支持的类型编译报错 */
+#ifdef __cplusplus
+	#define ULOG_KV(key, val)   ulog_kv_of(key, val)
+#else
+	#define ULOG_KV(key, val) _Generic((val),                                           \
+		bool: ulog_kv_bool,                                                           \
+		char: ulog_kv_int, signed char: ulog_kv_int, short: ulog_kv_int,              \
+		int: ulog_kv_int, long: ulog_kv_int, long long: ulog_kv_int,                  \
+		unsigned char: ulog_kv_uint, unsigned short: ulog_kv_uint,                    \
+		unsigned int: ulog_kv_uint, unsigned long: ulog_kv_uint,                      \
+		unsigned long long: ulog_kv_uint,                                             \
+		float: ulog_kv_float, double: ulog_kv_float,                                  \
+		char *: ulog_kv_str, const char *: ulog_kv_str)(key, val)
+#endif
+#define ULOG_KV_HEX(key, buf, size) ulog_kv_bytes(key, buf, size)
+
+#define ULOG_KV_EMIT(lvl, lv, tid, tag, msg, ...) do {                              \
+		if (ULOG_LIMIT_ON(lvl)) {                                                     \
+			const ulog_kv_t ulog_kv_[] = { __VA_ARGS__ };                             \
+			ulog_kv_output(tid, lv, tag, msg, ulog_kv_, sizeof(ulog_kv_) / sizeof(ulog_kv_[0])); \
+		}                                                                             \
+	} while (0)
+
+#define ULOG_KV_A(msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_ASSERT, 'A', ULOG_RTT_TERMINAL_ID, ULOG_TAG, msg, __VA_ARGS__)
+#define ULOG_KV_E(msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_ERROR, 'E', ULOG_RTT_TERMINAL_ID, ULOG_TAG, msg, __VA_ARGS__)
+#define ULOG_KV_W(msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_WARN, 'W', ULOG_RTT_TERMINAL_ID, ULOG_TAG, msg, __VA_ARGS__)
+#define ULOG_KV_I(msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_INFO, 'I', ULOG_RTT_TERMINAL_ID, ULOG_TAG, msg, __VA_ARGS__)
+#define ULOG_KV_D(msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_DEBUG, 'D', ULOG_RTT_TERMINAL_ID, ULOG_TAG, msg, __VA_ARGS__)
+#define ULOG_KV_V(msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_VERBOSE, 'V', ULOG_RTT_TERMINAL_ID, ULOG_TAG, msg, __VA_ARGS__)
+
+#define ULOG_KV_A_TAG(tag, msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_ASSERT, 'A', ULOG_RTT_TERMINAL_ID, tag, msg, __VA_ARGS__)
+#define ULOG_KV_E_TAG(tag, msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_ERROR, 'E', ULOG_RTT_TERMINAL_ID, tag, msg, __VA_ARGS__)
+#define ULOG_KV_W_TAG(tag, msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_WARN, 'W', ULOG_RTT_TERMINAL_ID, tag, msg, __VA_ARGS__)
+#define ULOG_KV_I_TAG(tag, msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_INFO, 'I', ULOG_RTT_TERMINAL_ID, tag, msg, __VA_ARGS__)
+#define ULOG_KV_D_TAG(tag, msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_DEBUG, 'D', ULOG_RTT_TERMINAL_ID, tag, msg, __VA_ARGS__)
+#define ULOG_KV_V_TAG(tag, msg, ...) ULOG_KV_EMIT(ULOG_LEVEL_VERBOSE, 'V', ULOG_RTT_TERMINAL_ID, tag, msg, __VA_ARGS__)
+#endif /* LOG_ENABLE_KV */
+
+#if LOG_ENABLE_METRIC
+/* 指标聚合宏：name、lo、hi 须为常量，value 按 int32_t 累计。低于 ULOG_STATIC_LEVEL 的级别展开为空，
+ * 汇总行经过运行时级别和过滤器 */
+#define ULOG_METRIC_WIDTH(lo, hi)                                                 \
+	(((hi) > (lo)) ? (uint32_t)(((int64_t)(hi) - (lo) + LOG_METRIC_BUCKETS - 1) / LOG_METRIC_BUCKETS) : 0u)
+#define ULOG_METRIC_EMIT(lvl, lv, tid, tag, name, value, lo, hi) do {               \
+		if (ULOG_LIMIT_ON(lvl)) {                                                     \
+			static ulog_metric_t ulog_metric_ = {                                     \
+				name, (lo), (hi), ULOG_METRIC_WIDTH(lo, hi),                          \
+				NULL, 0, 0, 0, NULL, 0, INT32_MAX, INT32_MIN, 0, { 0 } };             \
+			ulog_metric_update(&ulog_metric_, tid, lv, tag, (int32_t)(value));       \
+		}                                                                             \
+	} while (0)
+#else
+#define ULOG_METRIC_EMIT(lvl, lv, tid, tag, name, value, lo, hi) ((void)0)
+#endif
+
+#define ULOG_METRIC_A(name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_ASSERT, 'A', ULOG_RTT_TERMINAL_ID, ULOG_TAG, name, value, lo, hi)
+#define ULOG_METRIC_E(name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_ERROR, 'E', ULOG_RTT_TERMINAL_ID, ULOG_TAG, name, value, lo, hi)
+#define ULOG_METRIC_W(name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_WARN, 'W', ULOG_RTT_TERMINAL_ID, ULOG_TAG, name, value, lo, hi)
+#define ULOG_METRIC_I(name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_INFO, 'I', ULOG_RTT_TERMINAL_ID, ULOG_TAG, name, value, lo, hi)
+#define ULOG_METRIC_D(name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_DEBUG, 'D', ULOG_RTT_TERMINAL_ID, ULOG_TAG, name, value, lo, hi)
+#define ULOG_METRIC_V(name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_VERBOSE, 'V', ULOG_RTT_TERMINAL_ID, ULOG_TAG, name, value, lo, hi)
+
+#define ULOG_METRIC_A_TAG(tag, name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_ASSERT, 'A', ULOG_RTT_TERMINAL_ID, tag, name, value, lo, hi)
+#define ULOG_METRIC_E_TAG(tag, name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_ERROR, 'E', ULOG_RTT_TERMINAL_ID, tag, name, value, lo, hi)
+#define ULOG_METRIC_W_TAG(tag, name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_WARN, 'W', ULOG_RTT_TERMINAL_ID, tag, name, value, lo, hi)
+#define ULOG_METRIC_I_TAG(tag, name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_INFO, 'I', ULOG_RTT_TERMINAL_ID, tag, name, value, lo, hi)
+#define ULOG_METRIC_D_TAG(tag, name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_DEBUG, 'D', ULOG_RTT_TERMINAL_ID, tag, name, value, lo, hi)
+#define ULOG_METRIC_V_TAG(tag, name, value, lo, hi) ULOG_METRIC_EMIT(ULOG_LEVEL_VERBOSE, 'V', ULOG_RTT_TERMINAL_ID, tag, name, value, lo, hi)
 
 /* 原始日志（无标签、无级别，仅输出内容） */
 #if ULOG_OUTPUT_DISABLE
@@ -219,17 +924,36 @@ void ulog_output_ex(unsigned char terminal_id,char level, const char *tag,const
 	#define ULOG_RAW(fmt, ...) ulog_output_ex(ULOG_RTT_TERMINAL_ID, 0, "", fmt, ##__VA_ARGS__)
 #endif
 
-/* Hexdump 快捷宏封装   */  
-#if ULOG_OUTPUT_DISABLE
+/* Hexdump 快捷宏封装，按 DEBUG 级别裁剪   */  
+#if ULOG_OUTPUT_DISABLE || (ULOG_STATIC_LEVEL < ULOG_LEVEL_DEBUG)
     #define ULOG_HEX(name, buf, size) 	((void)0)
+    #define ULOG_HEX_T(tid, name, buf, size) 	((void)0)
 #else
 	#define ULOG_HEX(name, buf, size) 	ulog_hexdump(name, ULOG_HEX_WIDTH, buf, size)
+	#define ULOG_HEX_T(tid, name, buf, size) 	ulog_hexdump_ex(tid, 'D', name, ULOG_HEX_WIDTH, buf, size)
 #endif                                                    
 
 #ifdef __cplusplus
 }
 #endif
 
+#if LOG_ENABLE_KV && defined(__cplusplus)
+/* C++：ULOG_KV 的类型分派；整数和枚举走模板，其余类型为精确匹配的重载 */
+#include <type_traits>
+
+template <typename T>
+inline ulog_kv_t ulog_kv_of(const char *key, T val)
+{
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "unsupported ULOG_KV value type");
+    return (std::is_signed<T>::value || std::is_enum<T>::value) ? ulog_kv_int(key, (int64_t)val) : ulog_kv_uint(key, (uint64_t)val);
+}
+inline ulog_kv_t ulog_kv_of(const char *key, bool val)         { return ulog_kv_bool(key, val); }
+inline ulog_kv_t ulog_kv_of(const char *key, float val)        { return ulog_kv_float(key, val); }
+inline ulog_kv_t ulog_kv_of(const char *key, double val)       { return ulog_kv_float(key, val); }
+inline ulog_kv_t ulog_kv_of(const char *key, char *val)        { return ulog_kv_str(key, val); }
+inline ulog_kv_t ulog_kv_of(const char *key, const char *val)  { return ulog_kv_str(key, val); }
+#endif
+
 #endif /* __UNIFIED_LOG_H */
 
 
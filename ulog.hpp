@@ -0,0 +1,709 @@
+/**
+  ******************************************************************************
+  * @file           : ulog.hpp
+  * @brief          : 统一日志系统 C++ 前端（C++20，仅头文件）
+  *                   编译期解析格式串并检查参数类型，运行时不解析格式串、不经过 va_list
+  ******************************************************************************
+  * @attention
+  *
+  * ulog::info<"NET">("send seq={} len={:#06x} rate={:.2f}", seq, len, rate);
+  * ulog::warn("queue {} full", name);                  标签为 ULOG_TAG
+  * ulog::output<'E', "NET">(terminal, "lost {}", n);   指定 RTT 终端
+  *
+  * 占位符为 {} 或 {:[[fill]align][sign][#][0][width][.precision][type]}，{{ 和 }} 为大括号本身：
+  *   整数      d x X o b B c       bool   s d x X o b B
+  *   char      c d x X o b B       浮点   f F e E（precision <= 9，省略 type 时最多 6 位小数并去掉末尾的 0）
+  *   字符串    s（precision 为最多输出的字符数）      指针   p
+  * 占位符个数或 type 与参数不符时编译报错。每种参数类型组合生成一个渲染函数，由 ulog_output_render
+  * 在级别判断通过后直接写入记录缓冲区，之后与 C 宏一样经过过滤、提交缓冲区和各后端，并自动追加 "\r\n"。
+  ******************************************************************************
+  */
+
+#ifndef __ULOG_HPP_
+#define __ULOG_HPP_
+
+#if !defined(__cplusplus) || (__cplusplus < 202002L)
+#error "ulog.hpp requires C++20"
+#endif
+
+#include "ulog.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace ulog {
+namespace detail {
+
+/* -------------------------------------------------------------------------- */
+/* 编译期：标签与格式串解析                                                   */
+/* -------------------------------------------------------------------------- */
+/* 标签作为模板参数，实例化后是唯一的静态对象，地址可用于 C 端的标签缓存 */
+template <std::size_t N>
+struct fixed_string {
+    char s[N] {};
+
+    consteval fixed_string(const char (&str)[N])
+    {
+        for (std::size_t i = 0; i < N; i++) {
+            s[i] = str[i];
+        }
+    }
+};
+
+/* 非 constexpr：在编译期解析中被调用即编译错误，报错信息中带有 msg */
+inline void format_error(const char *msg)
+{
+    (void)msg;
+}
+
+enum class kind : std::uint8_t { sint, uint, chr, boolean, flt, str, ptr };
+
+template <class T>
+inline constexpr bool unsupported = false;
+
+template <class T>
+consteval kind kind_of()
+{
+    using U = std::remove_cvref_t<T>;
+
+    if constexpr (std::is_same_v<U, bool>) {
+        return kind::boolean;
+    } else if constexpr (std::is_same_v<U, char>) {
+        return kind::chr;
+    } else if constexpr (std::is_enum_v<U>) {
+        return std::is_signed_v<std::underlying_type_t<U>> ? kind::sint : kind::uint;
+    } else if constexpr (std::is_integral_v<U>) {
+        return std::is_signed_v<U> ? kind::sint : kind::uint;
+    } else if constexpr (std::is_floating_point_v<U>) {
+        return kind::flt;
+    } else if constexpr (std::is_array_v<U> && std::is_same_v<std::remove_cv_t<std::remove_extent_t<U>>, char>) {
+        return kind::str;
+    } else if constexpr (std::is_pointer_v<U> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<U>>, char>) {
+        return kind::str;
+    } else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>) {
+        return kind::ptr;
+    } else if constexpr (std::is_convertible_v<const U &, std::string_view>) {
+        return kind::str;
+    } else {
+        static_assert(unsupported<U>, "ulog: unsupported argument type");
+        return kind::ptr;
+    }
+}
+
+struct spec {
+    char          fill  = ' ';
+    char          align = 0;        /* '<' '>' '^'，0 为默认：数值右对齐，其余左对齐 */
+    char          sign  = '-';      /* '-' '+' ' ' */
+    bool          alt   = false;
+    bool          zero  = false;
+    char          type  = 0;
+    std::uint16_t width = 0;
+    std::int16_t  prec  = -1;
+};
+
+/* 占位符及其之前的字面文本；esc 表示文本中有 {{ 或 }} */
+struct field {
+    std::uint16_t off = 0;
+    std::uint16_t len = 0;
+    bool          esc = false;
+    spec          sp;
+};
+
+/* arg[N] 只有字面文本：最后一个占位符之后的部分 */
+template <std::size_t N>
+struct parsed_format {
+    field arg[N + 1];
+};
+
+consteval bool is_align(char c)
+{
+    return c == '<' || c == '>' || c == '^';
+}
+
+consteval std::uint16_t parse_num(std::string_view f, std::size_t &i, unsigned max)
+{
+    unsigned v = 0;
+    while (i < f.size() && f[i] >= '0' && f[i] <= '9') {
+        v = v * 10 + (unsigned)(f[i++] - '0');
+        if (v > max) {
+            format_error("ulog: width or precision too large");
+        }
+    }
+    return (std::uint16_t)v;
+}
+
+consteval std::size_t parse_spec(std::string_view f, std::size_t i, spec &sp)
+{
+    if (i + 1 < f.size() && is_align(f[i + 1]) && f[i] != '{' && f[i] != '}') {
+        sp.fill  = f[i];
+        sp.align = f[i + 1];
+        i += 2;
+    } else if (i < f.size() && is_align(f[i])) {
+        sp.align = f[i++];
+    }
+    if (i < f.size() && (f[i] == '+' || f[i] == '-' || f[i] == ' ')) {
+        sp.sign = f[i++];
+    }
+    if (i < f.size() && f[i] == '#') {
+        sp.alt = true;
+        i++;
+    }
+    if (i < f.size() && f[i] == '0') {
+        sp.zero = true;
+        i++;
+    }
+    sp.width = parse_num(f, i, 255);
+    if (i < f.size() && f[i] == '.') {
+        i++;
+        if (i >= f.size() || f[i] < '0' || f[i] > '9') {
+            format_error("ulog: missing precision after '.'");
+        }
+        sp.prec = (std::int16_t)parse_num(f, i, 1023);
+    }
+    if (i < f.size() && f[i] != '}') {
+        sp.type = f[i++];
+    }
+    return i;
+}
+
+consteval bool type_in(char t, std::string_view allowed)
+{
+    return t == 0 || allowed.find(t) != std::string_view::npos;
+}
+
+consteval void check_spec(const spec &sp, kind k)
+{
+    bool numeric = false;
+
+    switch (k) {
+        case kind::sint:
+        case kind::uint:
+            if (!type_in(sp.type, "dxXobBc")) {
+                format_error("ulog: integer argument needs type d x X o b B or c");
+            }
+            numeric = (sp.type != 'c');
+            break;
+        case kind::chr:
+            if (!type_in(sp.type, "cdxXobB")) {
+                format_error("ulog: char argument needs type c d x X o b or B");
+            }
+            numeric = (sp.type != 0 && sp.type != 'c');
+            break;
+        case kind::boolean:
+            if (!type_in(sp.type, "sdxXobB")) {
+                format_error("ulog: bool argument needs type s d x X o b or B");
+            }
+            numeric = (sp.type != 0 && sp.type != 's');
+            break;
+        case kind::flt:
+            if (!type_in(sp.type, "fFeE")) {
+                format_error("ulog: floating-point argument needs type f F e or E");
+            }
+            if (sp.prec > 9) {
+                format_error("ulog: floating-point precision must be <= 9");
+            }
+            return;
+        case kind::str:
+            if (!type_in(sp.type, "s")) {
+                format_error("ulog: string argument needs type s");
+            }
+            break;
+        case kind::ptr:
+            if (!type_in(sp.type, "p")) {
+                format_error("ulog: pointer argument needs type p");
+            }
+            numeric = true;
+            break;
+    }
+    if (sp.prec >= 0 && k != kind::str) {
+        format_error("ulog: precision is only valid for strings and floating-point values");
+    }
+    if (!numeric && (sp.sign != '-' || sp.alt || sp.zero)) {
+        format_error("ulog: sign, '#' and '0' are only valid for numbers");
+    }
+}
+
+template <class... Args>
+consteval parsed_format<sizeof...(Args)> parse(std::string_view f)
+{
+    constexpr std::size_t N = sizeof...(Args);
+    constexpr kind kinds[] = { kind_of<Args>()..., kind::ptr };
+    parsed_format<N> p {};
+    std::size_t i = 0;
+    std::size_t lit = 0;
+    std::size_t n = 0;
+    bool esc = false;
+
+    if (f.size() > 0xFFFF) {
+        format_error("ulog: format string too long");
+    }
+    while (i < f.size()) {
+        if ((f[i] == '{' || f[i] == '}') && i + 1 < f.size() && f[i + 1] == f[i]) {
+            esc = true;
+            i += 2;
+            continue;
+        }
+        if (f[i] == '}') {
+            format_error("ulog: unmatched '}' in format string");
+        }
+        if (f[i] != '{') {
+            i++;
+            continue;
+        }
+        if (n >= N) {
+            format_error("ulog: more placeholders than arguments");
+        }
+
+        field &fd = p.arg[n];
+        fd.off = (std::uint16_t)lit;
+        fd.len = (std::uint16_t)(i - lit);
+        fd.esc = esc;
+        i++;
+        if (i < f.size() && f[i] == ':') {
+            i = parse_spec(f, i + 1, fd.sp);
+        }
+        if (i >= f.size() || f[i] != '}') {
+            format_error("ulog: invalid placeholder, expected {} or {:spec}");
+        }
+        check_spec(fd.sp, kinds[n]);
+        i++;
+        n++;
+        lit = i;
+        esc = false;
+    }
+    if (n != N) {
+        format_error("ulog: fewer placeholders than arguments");
+    }
+    p.arg[N].off = (std::uint16_t)lit;
+    p.arg[N].len = (std::uint16_t)(f.size() - lit);
+    p.arg[N].esc = esc;
+    return p;
+}
+
+consteval int level_value(char level)
+{
+    switch (level) {
+        case 'A': return ULOG_LEVEL_ASSERT;
+        case 'E': return ULOG_LEVEL_ERROR;
+        case 'W': return ULOG_LEVEL_WARN;
+        case 'I': return ULOG_LEVEL_INFO;
+        case 'D': return ULOG_LEVEL_DEBUG;
+        case 'V': return ULOG_LEVEL_VERBOSE;
+        default : format_error("ulog: level must be one of A E W I D V"); return 0;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* 运行时：参数值与渲染                                                       */
+/* -------------------------------------------------------------------------- */
+/* 参数按类别存放；C 字符串在渲染时才计算长度，被级别屏蔽的日志不做 strlen */
+union value {
+    std::int64_t  i;
+    std::uint64_t u;
+    double        f;
+    const void   *p;
+    char          c;
+    bool          b;
+    struct {
+        const char  *s;
+        std::size_t  n;         /* string_view 的长度，或 C 字符串的最大长度 */
+        bool         cstr;
+    } str;
+};
+
+template <class T>
+inline value to_value(const T &a)
+{
+    using U = std::remove_cvref_t<T>;
+    constexpr kind k = kind_of<T>();
+    value v;
+
+    if constexpr (k == kind::boolean) {
+        v.b = a;
+    } else if constexpr (k == kind::chr) {
+        v.c = a;
+    } else if constexpr (k == kind::sint) {
+        v.i = (std::int64_t)a;
+    } else if constexpr (k == kind::uint) {
+        v.u = (std::uint64_t)a;
+    } else if constexpr (k == kind::flt) {
+        v.f = (double)a;
+    } else if constexpr (k == kind::str && std::is_array_v<U>) {
+        v.str = { a, std::extent_v<U>, true };
+    } else if constexpr (k == kind::str && std::is_pointer_v<U>) {
+        v.str = { a, (std::size_t)-1, true };
+    } else if constexpr (k == kind::str) {
+        std::string_view sv(a);
+        v.str = { sv.data(), sv.size(), false };
+    } else {
+        v.p = (const void *)a;
+    }
+    return v;
+}
+
+/* 完整正文的长度可以超过 size，超出部分不写入，由 ulog_output_render 判断截断 */
+struct writer {
+    char        *buf;
+    std::size_t  size;
+    std::size_t  len;
+
+    void put(const char *s, std::size_t n)
+    {
+        if (len < size) {
+            std::memcpy(buf + len, s, (n < size - len) ? n : size - len);
+        }
+        len += n;
+    }
+
+    void fill(char c, std::size_t n)
+    {
+        if (len < size) {
+            std::memset(buf + len, c, (n < size - len) ? n : size - len);
+        }
+        len += n;
+    }
+};
+
+/* 字面文本；只有含 {{ }} 的段才逐字符处理 */
+inline void put_literal(writer &w, const char *str, const field &fd)
+{
+    const char *s = str + fd.off;
+
+    if (!fd.esc) {
+        w.put(s, fd.len);
+        return;
+    }
+    for (std::size_t i = 0; i < fd.len; i++) {
+        w.put(&s[i], 1);
+        if (s[i] == '{' || s[i] == '}') {
+            i++;
+        }
+    }
+}
+
+/* pre 为符号和进制前缀；数值的 0 标志在前缀之后补 0 */
+inline void put_padded(writer &w, const spec &sp, const char *pre, std::size_t pn,
+                       const char *s, std::size_t n, bool numeric)
+{
+    std::size_t total = pn + n;
+    std::size_t pad = (sp.width > total) ? sp.width - total : 0;
+
+    if (numeric && sp.zero && sp.align == 0) {
+        w.put(pre, pn);
+        w.fill('0', pad);
+        w.put(s, n);
+        return;
+    }
+    char align = sp.align ? sp.align : (numeric ? '>' : '<');
+    std::size_t left = (align == '>') ? pad : (align == '^') ? pad / 2 : 0;
+    w.fill(sp.fill, left);
+    w.put(pre, pn);
+    w.put(s, n);
+    w.fill(sp.fill, pad - left);
+}
+
+inline std::size_t to_digits(char *out, std::uint64_t v, unsigned base, bool upper)
+{
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char tmp[64];
+    std::size_t n = 0;
+
+    /* 32 位值走快速路径，避免 MCU 上的 64 位除法 */
+    if (v <= 0xFFFFFFFFu) {
+        std::uint32_t x = (std::uint32_t)v;
+        do {
+            tmp[n++] = digits[x % base];
+            x /= base;
+        } while (x);
+    } else {
+        do {
+            tmp[n++] = digits[v % base];
+            v /= base;
+        } while (v);
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        out[i] = tmp[n - 1 - i];
+    }
+    return n;
+}
+
+inline void put_integer(writer &w, const spec &sp, std::uint64_t u, bool neg)
+{
+    char pre[3];
+    std::size_t pn = 0;
+    char digits[64];
+    unsigned base = 10;
+
+    if (sp.type == 'c') {
+        char c = (char)u;
+        put_padded(w, sp, "", 0, &c, 1, false);
+        return;
+    }
+    if (neg) {
+        pre[pn++] = '-';
+    } else if (sp.sign != '-') {
+        pre[pn++] = sp.sign;
+    }
+    switch (sp.type) {
+        case 'x': case 'X': base = 16; break;
+        case 'o':           base = 8;  break;
+        case 'b': case 'B': base = 2;  break;
+        default : break;
+    }
+    if (sp.alt && base != 10 && (base != 8 || u != 0)) {
+        pre[pn++] = '0';
+        if (base != 8) {
+            pre[pn++] = sp.type;    /* x X b B */
+        }
+    }
+    put_padded(w, sp, pre, pn, digits, to_digits(digits, u, base, sp.type == 'X'), true);
+}
+
+/* 非负有限值按 prec 位小数写入 out；trim 时去掉小数末尾的 0。整数部分须小于 2^64 */
+inline std::size_t to_fixed(char *out, double v, int prec, bool trim)
+{
+    static constexpr std::uint32_t scale_tab[] = {
+        1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+    };
+    const std::uint32_t scale = scale_tab[prec];
+    std::uint64_t ip = (std::uint64_t)v;
+    std::uint32_t fp = (std::uint32_t)((v - (double)ip) * scale + 0.5);
+
+    if (fp >= scale) {
+        ip++;
+        fp -= scale;
+    }
+    std::size_t n = to_digits(out, ip, 10, false);
+    if (trim) {
+        while (prec > 0 && fp % 10 == 0) {
+            fp /= 10;
+            prec--;
+        }
+    }
+    if (prec > 0) {
+        out[n++] = '.';
+        for (int i = prec - 1; i >= 0; i--) {
+            out[n + (std::size_t)i] = (char)('0' + fp % 10);
+            fp /= 10;
+        }
+        n += (std::size_t)prec;
+    }
+    return n;
+}
+
+inline std::size_t to_exp(char *out, double v, int prec, bool trim, bool upper)
+{
+    int e = 0;
+
+    if (v != 0.0) {
+        while (v >= 10.0) {
+            v /= 10.0;
+            e++;
+        }
+        while (v < 1.0) {
+            v *= 10.0;
+            e--;
+        }
+    }
+    std::size_t n = to_fixed(out, v, prec, trim);
+    if (n >= 2 && out[0] == '1' && out[1] == '0') {
+        /* 9.99... 进位成 10 */
+        n = to_fixed(out, v / 10.0, prec, trim);
+        e++;
+    }
+    out[n++] = upper ? 'E' : 'e';
+    out[n++] = (e < 0) ? '-' : '+';
+    unsigned ae = (unsigned)((e < 0) ? -e : e);
+    if (ae < 10) {
+        out[n++] = '0';
+    }
+    return n + to_digits(out + n, ae, 10, false);
+}
+
+inline void put_float(writer &w, const spec &sp, double v)
+{
+    char pre[1];
+    std::size_t pn = 0;
+    char body[40];
+    std::size_t n;
+    bool upper = (sp.type == 'F' || sp.type == 'E');
+    int prec = (sp.prec >= 0) ? sp.prec : 6;
+
+    std::uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    if (bits >> 63) {
+        pre[pn++] = '-';
+        v = -v;
+    } else if (sp.sign != '-') {
+        pre[pn++] = sp.sign;
+    }
+    if (v != v || v - v != 0.0) {
+        /* NaN / Inf 不补 0 */
+        spec s = sp;
+        s.zero = false;
+        put_padded(w, s, pre, pn, (v != v) ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf"), 3, true);
+        return;
+    }
+    if (sp.type == 'e' || sp.type == 'E') {
+        n = to_exp(body, v, prec, false, upper);
+    } else if (sp.type != 0) {
+        n = (v < 1.8e19) ? to_fixed(body, v, prec, false) : to_exp(body, v, prec, false, upper);
+    } else if (v >= 1e15 || (v > 0 && v < 1e-4)) {
+        n = to_exp(body, v, prec, true, false);
+    } else {
+        n = to_fixed(body, v, prec, true);
+    }
+    put_padded(w, sp, pre, pn, body, n, true);
+}
+
+inline void put_string(writer &w, const spec &sp, const value &v)
+{
+    const char *s = v.str.s;
+    std::size_t n = v.str.n;
+
+    if (sp.prec >= 0 && (std::size_t)sp.prec < n) {
+        n = (std::size_t)sp.prec;
+    }
+    if (s == nullptr) {
+        s = "(null)";
+        n = (n < 6) ? n : 6;
+    } else if (v.str.cstr) {
+        const void *end = std::memchr(s, '\0', n);
+        if (end != nullptr) {
+            n = (std::size_t)((const char *)end - s);
+        }
+    }
+    put_padded(w, sp, "", 0, s, n, false);
+}
+
+template <kind K>
+inline void put_value(writer &w, const spec &sp, const value &v)
+{
+    if constexpr (K == kind::sint) {
+        put_integer(w, sp, (v.i < 0) ? 0ULL - (std::uint64_t)v.i : (std::uint64_t)v.i, v.i < 0);
+    } else if constexpr (K == kind::uint) {
+        put_integer(w, sp, v.u, false);
+    } else if constexpr (K == kind::chr) {
+        if (sp.type == 0 || sp.type == 'c') {
+            put_padded(w, sp, "", 0, &v.c, 1, false);
+        } else {
+            put_integer(w, sp, (unsigned char)v.c, false);
+        }
+    } else if constexpr (K == kind::boolean) {
+        if (sp.type == 0 || sp.type == 's') {
+            put_padded(w, sp, "", 0, v.b ? "true" : "false", v.b ? 4 : 5, false);
+        } else {
+            put_integer(w, sp, v.b ? 1 : 0, false);
+        }
+    } else if constexpr (K == kind::flt) {
+        put_float(w, sp, v.f);
+    } else if constexpr (K == kind::str) {
+        put_string(w, sp, v);
+    } else {
+        char digits[16];
+        put_padded(w, sp, "0x", 2, digits, to_digits(digits, (std::uintptr_t)v.p, 16, false), true);
+    }
+}
+
+template <kind... K>
+struct call {
+    const char  *str;
+    const field *fmt;
+    value        v[sizeof...(K) + 1];
+};
+
+template <kind... K, std::size_t... I>
+inline std::size_t render_all(char *buf, std::size_t size, const call<K...> &c, std::index_sequence<I...>)
+{
+    writer w { buf, size, 0 };
+
+    ((put_literal(w, c.str, c.fmt[I]), put_value<K>(w, c.fmt[I].sp, c.v[I])), ...);
+    put_literal(w, c.str, c.fmt[sizeof...(K)]);
+    return w.len;
+}
+
+template <kind... K>
+std::size_t render(char *buf, std::size_t size, const void *ctx)
+{
+    return render_all(buf, size, *static_cast<const call<K...> *>(ctx), std::make_index_sequence<sizeof...(K)>());
+}
+
+} /* namespace detail */
+
+/* -------------------------------------------------------------------------- */
+/* 格式串与输出接口                                                           */
+/* -------------------------------------------------------------------------- */
+/* 只能由字符串字面量构造，构造时在编译期解析并检查参数 */
+template <class... Args>
+struct basic_format_string {
+    const char                                  *str;
+    detail::parsed_format<sizeof...(Args)>       parsed;
+
+    template <std::size_t N>
+    consteval basic_format_string(const char (&s)[N])
+        : str(s), parsed(detail::parse<Args...>(std::string_view(s, N - 1)))
+    {
+    }
+};
+
+/* Args 由参数推导，格式串不参与推导 */
+template <class... Args>
+using format_string = basic_format_string<std::type_identity_t<Args>...>;
+
+/* StaticLevel 取包含处的 ULOG_STATIC_LEVEL：不同阈值的文件得到不同的实例 */
+template <char Level, detail::fixed_string Tag = ULOG_TAG, int StaticLevel = ULOG_STATIC_LEVEL, class... Args>
+inline void output(unsigned char terminal_id, format_string<Args...> fmt, const Args &... args)
+{
+    if constexpr (!ULOG_OUTPUT_DISABLE && detail::level_value(Level) <= StaticLevel) {
+        const detail::call<detail::kind_of<Args>()...> c { fmt.str, fmt.parsed.arg, { detail::to_value(args)... } };
+        ulog_output_render(terminal_id, Level, Tag.s, &detail::render<detail::kind_of<Args>()...>, &c);
+    } else {
+        (void)terminal_id;
+        (void)fmt;
+        ((void)args, ...);
+    }
+}
+
+template <detail::fixed_string Tag = ULOG_TAG, int StaticLevel = ULOG_STATIC_LEVEL, class... Args>
+inline void assertion(format_string<Args...> fmt, const Args &... args)
+{
+    output<'A', Tag, StaticLevel>(ULOG_RTT_TERMINAL_ID, fmt, args...);
+}
+
+template <detail::fixed_string Tag = ULOG_TAG, int StaticLevel = ULOG_STATIC_LEVEL, class... Args>
+inline void error(format_string<Args...> fmt, const Args &... args)
+{
+    output<'E', Tag, StaticLevel>(ULOG_RTT_TERMINAL_ID, fmt, args...);
+}
+
+template <detail::fixed_string Tag = ULOG_TAG, int StaticLevel = ULOG_STATIC_LEVEL, class... Args>
+inline void warn(format_string<Args...> fmt, const Args &... args)
+{
+    output<'W', Tag, StaticLevel>(ULOG_RTT_TERMINAL_ID, fmt, args...);
+}
+
+template <detail::fixed_string Tag = ULOG_TAG, int StaticLevel = ULOG_STATIC_LEVEL, class... Args>
+inline void info(format_string<Args...> fmt, const Args &... args)
+{
+    output<'I', Tag, StaticLevel>(ULOG_RTT_TERMINAL_ID, fmt, args...);
+}
+
+template <detail::fixed_string Tag = ULOG_TAG, int StaticLevel = ULOG_STATIC_LEVEL, class... Args>
+inline void debug(format_string<Args...> fmt, const Args &... args)
+{
+    output<'D', Tag, StaticLevel>(ULOG_RTT_TERMINAL_ID, fmt, args...);
+}
+
+template <detail::fixed_string Tag = ULOG_TAG, int StaticLevel = ULOG_STATIC_LEVEL, class... Args>
+inline void verbose(format_string<Args...> fmt, const Args &... args)
+{
+    output<'V', Tag, StaticLevel>(ULOG_RTT_TERMINAL_ID, fmt, args...);
+}
+
+} /* namespace ulog */
+
+#endif /* __ULOG_HPP_ */
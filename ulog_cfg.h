@@ -30,7 +30,26 @@ extern "C" {
  * ULOG_OUTPUT_ALL         - ͬʱʹʽ
  */
 #define ULOG_OUTPUT_DISABLE     0    /* ־ */
+#ifndef ULOG_OUTPUT_METHOD
 #define ULOG_OUTPUT_METHOD      (ULOG_OUTPUT_PRINTF)
+#endif
+
+/* printf Ļģʽɫǰ׺ֱӿлСʱ߼־齻
+ * дPOSIX Ĭ write(2)ƽ̨Ĭ fwrite(stdout) ulog_printf_set_write()  DMA UART */
+#ifndef LOG_PRINTF_BUFFERED
+#define LOG_PRINTF_BUFFERED     0
+#endif
+#if LOG_PRINTF_BUFFERED
+  #ifndef LOG_PRINTF_BUFFER_SIZE
+    #define LOG_PRINTF_BUFFER_SIZE  1024				/* ÿĴС˫壬 */
+  #endif
+  #ifndef LOG_PRINTF_FLUSH_MS
+    #define LOG_PRINTF_FLUSH_MS     20					/* ͣʱ (ms)0 = ʱд */
+  #endif
+  #ifndef LOG_PRINTF_FLUSH_LEVEL
+    #define LOG_PRINTF_FLUSH_LEVEL  ULOG_LEVEL_ERROR	/* ڸüֵڣ־д */
+  #endif
+#endif
 
 
 /* ־
@@ -40,52 +59,54 @@ extern "C" {
  * ULOG_LEVEL_INFO    (3) - Ϣ
  * ULOG_LEVEL_DEBUG   (4) - Լ
  * ULOG_LEVEL_VERBOSE (5) - ϸ
+ *
+ * ڸü ULOG_* ڱչΪ ((void)0)롢ֵ
  */
+#ifndef ULOG_LEVEL
 #define ULOG_LEVEL              	ULOG_LEVEL_VERBOSE
+#endif
 
-/* Ĭ־ǩ */
+/* Ĭ־ǩڰ ulog.h ֮ǰж ULOG_TAG  ULOG_MODULE */
+#ifndef ULOG_TAG
 #define ULOG_TAG               		"MAIN"
+#endif
 
+#ifndef ULOG_SHOW_LOG
 #define ULOG_SHOW_LOG				1
+#endif
 
 /* ʱɫ */
+#ifndef ULOG_COLOR_ENABLE
 #define ULOG_COLOR_ENABLE       	1			/* Ƿɫ */
+#endif
+#ifndef ULOG_WITH_TIMESTAMP
 #define ULOG_WITH_TIMESTAMP     	0			/* Ƿʱ */
+#endif
 
 #if ULOG_WITH_TIMESTAMP
-#define ULOG_TIMESTAMP_FORMAT   1   			/* 0 = 򵥺, 1 = d-h:m:s^ms */
-/**
- * @brief ȡ־ʱź
- * 
- * Ĭʵʹ HAL_GetTick()غ뼶 tick
- * ûԼļʵָú磺
- *   - FreeRTOS:   return xTaskGetTickCount();
- *   - RTC:        return rtc_get_time_ms();
- *   - Linux:      return (uint32_t)time(NULL);
+/* ʱʽ
+ * 0 - [123456 ms]
+ * 1 - [00d-00h:02m:03s^456ms]
+ * 2 - [00d-00h:02m:03s^456.789ms]΢룬Ҫ߾ʱԴ
  */
-static inline uint32_t ulog_get_timestamp(void) {
-    return HAL_GetTick();
-}
-
-static inline void ulog_get_timestamp_str(char *buf, size_t size) {
-    uint32_t tick = ulog_get_timestamp();
-
-#if (ULOG_WITH_TIMESTAMP == 0)
-    snprintf(buf, size, "[%lu ms]", (unsigned long)tick);
-
-#elif (ULOG_WITH_TIMESTAMP == 1)
-    uint32_t days         = tick / (1000 * 60 * 60 * 24);
-    uint32_t hours        = (tick / (1000 * 60 * 60)) % 24;
-    uint32_t minutes      = (tick / (1000 * 60)) % 60;
-    uint32_t seconds      = (tick / 1000) % 60;
-    uint32_t milliseconds = tick % 1000;
-
-    snprintf(buf, size, "[%02ud-%02uh:%02um:%02us^%03ums]",
-             days, hours, minutes, seconds, milliseconds);
+#ifndef ULOG_TIMESTAMP_FORMAT
+#define ULOG_TIMESTAMP_FORMAT   1
 #endif
-}
 #endif
 
+/* ʱʱԴLOG_ENABLE_RATE_LIMIT ٺҲʹ
+ * ULOG_TS_SOURCE_TICK      - HAL_GetTick()ֱ
+ * ULOG_TS_SOURCE_DWT       - Cortex-M3/M4/M7 DWT ڼƵΪ ULOG_TS_CPU_HZ
+ *                            ȡʱļСڼڣ2^32 / ULOG_TS_CPU_HZ 룩
+ * ULOG_TS_SOURCE_MONOTONIC - clock_gettime(CLOCK_MONOTONIC)Linux/POSIX
+ * ULOG_TS_SOURCE_USER      - ûʵ void ulog_timestamp_source(uint32_t *sec, uint32_t *usec)
+ */
+#ifndef ULOG_TS_SOURCE
+#define ULOG_TS_SOURCE          (ULOG_PORT_POSIX ? ULOG_TS_SOURCE_MONOTONIC : ULOG_TS_SOURCE_TICK)
+#endif
+#define ULOG_TS_CPU_HZ          SystemCoreClock		/* DWT Ƶ */
+#define ULOG_TS_DEVICE_HEADER   "main.h"			/* ṩ HAL_GetTick / DWT / SystemCoreClock */
+
 #if (!ULOG_COLOR_ENABLE)
 	#ifdef ELOG_COLOR_ENABLE
 	#undef ELOG_COLOR_ENABLE
@@ -96,15 +117,42 @@ static inline void ulog_get_timestamp_str(char *buf, size_t size) {
 /*  */
 #define ULOG_BUFFER_SIZE        512			/* ־С */
 #define ULOG_HEX_WIDTH          16			/* ʮÿֽ */
+#define ULOG_HEX_ASCII          1			/* ʮǷ񸽴 ASCII  */
+#define ULOG_HEX_MAX_BYTES      0			/* ֽ0 =  */
+#define ULOG_HEX_PACE()         ((void)0)	/* ÿύһã osDelay(1) */
+
+/* ͬʱעõ RTT/EasyLogger/printf */
+#define ULOG_MAX_BACKENDS       8
 
 /* RTT ն˺ */
 #define ULOG_RTT_TERMINAL_ID    0			/* Ĭʹն (0-10) */
 
+/* ƽ̨1 = Linux/POSIX (pthread)0 = MCU + CMSIS-RTOS2 */
+#ifndef ULOG_PORT_POSIX
+  #if defined(__unix__) || defined(__APPLE__)
+    #define ULOG_PORT_POSIX     1
+  #else
+    #define ULOG_PORT_POSIX     0
+  #endif
+#endif
+
+/* жϵǰǷжģCortex-M ɶΪ (__get_IPSR() != 0) */
+#ifndef ULOG_IN_ISR
+#define ULOG_IN_ISR()           0
+#endif
+
 /************************************************************
  * չܣĬϹرգ
  ************************************************************/
 
-/* ģ黯־ */
+/* ģ黯־
+ * Դļ ulog.h ֮ǰ ULOG_MODULE磺
+ *   #define ULOG_MODULE  UART
+ *   #include "ulog.h"
+ * ļıǩΪ "UART"ֵȡ LOG_LEVEL_UART  ULOG_LEVEL нϵߡ
+ * ±ûеģʹ ULOG_LEVELеֵд ULOG_LEVEL_xxx  0~5š
+ * ҲֱӶ ULOG_LOCAL_LEVEL ָļֵ
+ */
 #define LOG_MODULE_LEVELS      0
 #if LOG_MODULE_LEVELS
     #define LOG_LEVEL_MAIN     ULOG_LEVEL_INFO		/* ģ */
@@ -126,32 +174,212 @@ static inline void ulog_get_timestamp_str(char *buf, size_t size) {
 
 
 /* ־ */
+#ifndef LOG_ENABLE_FILTER
 #define LOG_ENABLE_FILTER      0
+#endif
 #if LOG_ENABLE_FILTER
     #define LOG_MAX_FILTER_TAGS     	10			/* ˱ǩ */
     #define LOG_MAX_FILTER_KEYWORDS 	5			/* ؼ */
+    #define LOG_FILTER_KEYWORD_LEN  	16			/* ؼ󳤶ȣ */
+#endif
+
+/* ʱǩʱƻ˿ʱ¼ÿǩļ͹״̬ */
+#if LOG_ENABLE_RUNTIME_LEVEL_CONTROL || LOG_ENABLE_FILTER
+    #define LOG_MAX_RUNTIME_TAGS    	32			/* ɵǼǵıǩ */
+    #define LOG_TAG_NAME_MAX        	16			/* ǩ󳤶ȣ */
+    #define LOG_TAG_CACHE_SIZE      	32			/* ǩַΪ 2  */
 #endif
 
 /* 첽־ */
+#ifndef LOG_ENABLE_ASYNC
 #define LOG_ENABLE_ASYNC       0
+#endif
 #if LOG_ENABLE_ASYNC
     #define LOG_ASYNC_BUFFER_SIZE   1024				/* 첽С */
     #define LOG_ASYNC_TASK_PRIORITY osPriorityNormal	/* 첽ȼ */
+    #define LOG_ASYNC_TASK_STACK    1024				/* 첽ջС (ֽ) */
+    #define LOG_ASYNC_CELL_SIZE     64					/* ԪСԪΪ 2  */
+    #define LOG_ASYNC_OVERFLOW      ULOG_ASYNC_DROP_NEWEST	/* ʱĴ */
+#endif
+
+/* ̰߳ȫͬ
+ * ־ڵԼջϸʽ¼ԭӵύɵǰû
+ * ߵĵνˡʽڼ䲻жͬʱʱ
+ * ¼ںвύ첽ģʽ߱ԣٿ
+ */
+#ifndef LOG_ENABLE_THREAD_SAFE
+#define LOG_ENABLE_THREAD_SAFE 0
+#endif
+#if LOG_ENABLE_THREAD_SAFE && !LOG_ENABLE_ASYNC
+    #define LOG_COMMIT_BUFFER_SIZE  1024				/* ύС */
+    #define LOG_COMMIT_CELL_SIZE    64					/* ԪСԪΪ 2  */
+    #define LOG_COMMIT_WAIT_TRIES   1000				/* ʱȴĴ */
+    /* ʱó CPU POSIXδʱΪ CMSIS-RTOS2  osDelay(1) RTOS ڴ˶壬
+     * #define LOG_THREAD_YIELD()      vTaskDelay(1)
+     * ־ʱǰ̱߳ʶʶ RTOS һ壬ֻܵȵȴޣ
+     * #define LOG_THREAD_ID()         ((const void *)xTaskGetCurrentTaskHandle()) */
+#endif
+
+/* жר ulog_output_isr() / ULOG_x_ISR() */
+#define LOG_ISR_BUFFER_SIZE    128						/* жеĸʽջϣ */
+#define LOG_ISR_RESERVE_TRIES  8						/* ԤೢԴ */
+
+/* ¼أ־ھ̬ĲиʽջϲҪ ULOG_BUFFER_SIZE Ļ
+ * ʱ˻ص LOG_POOL_FALLBACK_SIZE ջֽضϡ
+ */
+#ifndef LOG_ENABLE_RECORD_POOL
+#define LOG_ENABLE_RECORD_POOL 0
+#endif
+#if LOG_ENABLE_RECORD_POOL
+    #define LOG_POOL_SLOTS          4					/* ͬʱʽ־ */
+    #define LOG_POOL_SLOT_SIZE      ULOG_BUFFER_SIZE	/* ۴С */
+    #define LOG_POOL_FALLBACK_SIZE  96					/* ʱջС */
+#endif
+
+/* ־籩ULOG_x_ONCE / ULOG_x_EVERY_N ʼտã򿪺ṩʱٵ
+ * ULOG_x_EVERY_MSͰٵ ULOG_x_THROTTLEͬ־ϲΪ
+ * "last message repeated N times"ʱȡ ULOG_TS_SOURCE
+ */
+#ifndef LOG_ENABLE_RATE_LIMIT
+#define LOG_ENABLE_RATE_LIMIT  0
+#endif
+#if LOG_ENABLE_RATE_LIMIT
+    #define LOG_DEDUP_ENABLE        1					/* ϲͬ־ */
+    #define LOG_DEDUP_REPORT_MS     10000				/* ظʱÿһμ (ms) */
+    #define LOG_DEDUP_COPY_SIZE     128					/* һĵǰֽڣֽڱȽ */
+#endif
+
+/* ־õֻʽźԭʼ˽루 GCC/Clang + ELF */
+#ifndef LOG_ENABLE_BINARY
+#define LOG_ENABLE_BINARY      0
+#endif
+#if LOG_ENABLE_BINARY
+    #define LOG_BINARY_RECORD_SIZE  128					/* Ƽ¼ֽ (<= 257) */
+    #define LOG_BINARY_RTT_CHANNEL  0					/* Ƽ¼ʹõ RTT ͨ */
+#endif
+
+/* ṹ־ULOG_KV_x(msg, ULOG_KV("key", value), ...) ֵͱֵԣʽ */
+#ifndef LOG_ENABLE_KV
+#define LOG_ENABLE_KV          0
+#endif
+#if LOG_ENABLE_KV
+  #ifndef LOG_KV_FORMAT
+    #define LOG_KV_FORMAT           ULOG_KV_JSON		/* ULOG_KV_JSONJSON ģˣULOG_KV_TLV֡ */
+  #endif
+    #define LOG_KV_FLOAT_DIGITS     6					/* JSON иౣСλ (<= 9) */
+    #define LOG_KV_RTT_CHANNEL      0					/* TLV ֡ʹõ RTT ͨ */
+#endif
+
+/* м¼ LOG_FLIGHT_LEVEL ־Ĭ DEBUG/VERBOSEʽֻѸʽַ
+ * ԭʼ붨ۣERROR/ASSERT ֻ ulog_flight_flush() ʱȰԭ˳Щʷ
+ * ڼ ULOG_LEVEL Щ𣻸ʽΪַ
+ */
+#ifndef LOG_ENABLE_FLIGHT
+#define LOG_ENABLE_FLIGHT      0
+#endif
+#if LOG_ENABLE_FLIGHT
+  #ifndef LOG_FLIGHT_LEVEL
+    #define LOG_FLIGHT_LEVEL        ULOG_LEVEL_INFO		/* ڸüճֻʷ */
+  #endif
+    #define LOG_FLIGHT_TRIGGER      ULOG_LEVEL_ERROR	/* ڸü־ʷ */
+    #define LOG_FLIGHT_SLOTS        64					/* ʷΪ 2  */
+    #define LOG_FLIGHT_DATA_SIZE    48					/* ÿǩͲֽ (<= 255)Ĳض */
+#endif
+
+/* ־ͳƣǩ͵õ㣨ļ:Уͳµֽ͸ʽ/ʱ
+ * ڶλռ·־رʱ·κͳƴ롣
+ */
+#ifndef LOG_ENABLE_STATS
+#define LOG_ENABLE_STATS       0
+#endif
+#if LOG_ENABLE_STATS
+    #define LOG_STATS_TAGS          32					/* ǩΪ 2  */
+  #ifndef LOG_STATS_DUMP_MS
+    #define LOG_STATS_DUMP_MS       0					/* ÿԶܲ (ms)0 = ֻ ulog_stats_dump()  */
+  #endif
+    /* ʱԴص 32 λδʱ POSIX 룬ULOG_TS_SOURCE_DWT  DWT->CYCCNT
+     * ƽ̨ͳƺʱ #define LOG_STATS_CYCLES()  (DWT->CYCCNT) */
+#endif
+
+/* ָۺϣULOG_METRIC_x(name, value, lo, hi) ֻھ̬ۼƴС//ƽֵ
+ *  [lo, hi) ϵĶֱͼÿԸüͱǩһлܣʺϸƵң */
+#ifndef LOG_ENABLE_METRIC
+#define LOG_ENABLE_METRIC      0
+#endif
+#if LOG_ENABLE_METRIC
+  #ifndef LOG_METRIC_PERIOD_MS
+    #define LOG_METRIC_PERIOD_MS    1000				/*  (ms)0 = ֻ ulog_metric_dump()  */
+  #endif
+  #ifndef LOG_METRIC_BUCKETS
+    #define LOG_METRIC_BUCKETS      8					/* ֱͼͰ */
+  #endif
 #endif
 
 /* ־ļ */
+#ifndef LOG_ENABLE_FILE
 #define LOG_ENABLE_FILE        0
+#endif
 #if LOG_ENABLE_FILE
+  #ifndef LOG_FILE_PATH
     #define LOG_FILE_PATH      "/log/system.log"		/* ־ļ· */
+  #endif
     #define LOG_FILE_MAX_SIZE  (1024 * 1024)   			/* ־ļС (ֽ) */
     #define LOG_FILE_MAX_COUNT 5						/* ־ļ */
+    #define LOG_FILE_BUFFER_SIZE    (64 * 1024)			/* û̬дС */
+    #define LOG_FILE_FLUSH_MS       200					/* ͣʱ (ms) */
+    #define LOG_FILE_SYNC           ULOG_FILE_SYNC_ERROR	/* fsync  */
+    #define LOG_FILE_SYNC_MS        1000				/* ULOG_FILE_SYNC_PERIODIC  (ms) */
+#endif
+
+/* ־洢Linux/POSIX ulog_store.c¼дļ
+ * ͷʱ䷶Χͱǩϣtools/ulog_store_query.py ʱ//ǩֱӶλ */
+#ifndef LOG_ENABLE_STORE
+#define LOG_ENABLE_STORE       0
+#endif
+#if LOG_ENABLE_STORE
+    #define LOG_STORE_PATH          "/log/system.ulog"	/* 洢ļ· */
+    #define LOG_STORE_BLOCK_SIZE    (16 * 1024)			/* С (ֽ) */
+    #define LOG_STORE_MAX_BLOCKS    4096				/* д󸲸ɵĿ */
+    #define LOG_STORE_FLUSH_MS      500					/* ǰͣʱ (ms) */
+#endif
+
+/* ڴLinux/POSIX ulog_shm.c־д POSIX ڴеĻλ
+ * ÿ־ϵͳãtools/ulog_shm_view.c Ӻ桢ɫ͹ˣʱɵļ¼ */
+#ifndef LOG_ENABLE_SHM
+#define LOG_ENABLE_SHM         0
+#endif
+#if LOG_ENABLE_SHM
+    #define LOG_SHM_NAME            "/ulog"				/* shm_open ƣӦ /dev/shm/ulog */
+    #define LOG_SHM_SIZE            (256 * 1024)		/* С (ֽ)2  */
 #endif
 
 /* ־ */
+#ifndef LOG_ENABLE_NETWORK
 #define LOG_ENABLE_NETWORK     0
+#endif
 #if LOG_ENABLE_NETWORK
     #define LOG_NETWORK_HOST   "192.168.1.100"			/* ־ַ */
     #define LOG_NETWORK_PORT   514						/* ־˿ */
+    #define LOG_NETWORK_FACILITY    1					/* syslog facility1 = user */
+    #define LOG_NETWORK_MTU         1472				/*  UDP ֽ */
+    #define LOG_NETWORK_FLUSH_MS    100					/* δͣʱ (ms) */
+  #ifndef LOG_NETWORK_BATCH
+    #define LOG_NETWORK_BATCH       1					/* 1 = ¼ԻзָϲΪһ */
+  #endif
+#endif
+
+/* ־־ͬʱд븴λĻulog_init() ʱطţ ulog_crash.c
+ * MCU ӽűвʼĶΣ磺
+ *   .noinit (NOLOAD) : { *(.noinit*) } > RAM
+ */
+#ifndef LOG_ENABLE_CRASH_LOG
+#define LOG_ENABLE_CRASH_LOG   0
+#endif
+#if LOG_ENABLE_CRASH_LOG
+    #define LOG_CRASH_SIZE          4096				/* С (ֽ)2  */
+    #define LOG_CRASH_SECTION       ".noinit"			/* MCUڶ */
+    #define LOG_CRASH_FILE          "/tmp/ulog_crash.bin"	/* POSIXӳļ治 RAM */
+    #define LOG_CRASH_REPLAY        1					/* ϴ쳣ֹʱulog_init()  */
 #endif
 
 /* ʱŻ */
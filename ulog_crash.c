@@ -0,0 +1,245 @@
+#include "ulog.h"
+
+#if LOG_ENABLE_CRASH_LOG
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/* ύʱжϿͬʱд */
+#define CRASH_CONCURRENT    (LOG_ENABLE_ASYNC || LOG_ENABLE_THREAD_SAFE)
+
+#if ULOG_PORT_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* ־λĻ                                               */
+/* -------------------------------------------------------------------------- */
+/* ÿ־ύʱ첽/ύ֮ǰǰ׺׷ӵ LOG_CRASH_SIZE
+ * ֽڵĻδ˵־ҲСдֻһԭӼӺһο
+ * MCU ϻλ LOG_CRASH_SECTIONӽűΪ NOLOAD벻㣩
+ * POSIX ӳ䵽 LOG_CRASH_FILE̱ɱļС
+ * ͷ magicsizeboots  CRC32 У飬ϵݲᱻ־
+ * ulog_deinit()  state Ϊ´ ulog_init() ʱ state 
+ * Ϊϴ쳣ֹѻݻطŵˡλĳ¼
+ * ;ʱ¼ܲ */
+#if (LOG_CRASH_SIZE & (LOG_CRASH_SIZE - 1)) || (LOG_CRASH_SIZE < 256)
+#error "LOG_CRASH_SIZE must be a power of two >= 256"
+#endif
+
+#define CRASH_MAGIC         0x554C4352u     /* "ULCR" */
+#define CRASH_RUNNING       0x52554E21u
+#define CRASH_CLEAN         0x434C4E21u
+#define CRASH_MASK          (LOG_CRASH_SIZE - 1u)
+
+typedef struct {
+    uint32_t          magic;
+    uint32_t          size;
+    uint32_t          boots;        /* ʹø */
+    uint32_t          crc;          /* ֶε CRC32 */
+    volatile uint32_t state;        /* CRASH_RUNNING / CRASH_CLEAN */
+    volatile uint32_t full;         /* дһȦhead ƣ 4 GiBж */
+    atomic_uint       head;         /* ۼдֽдλΪ head & CRASH_MASK */
+    char              data[LOG_CRASH_SIZE];
+} ulog_crash_region_t;
+
+#if ULOG_PORT_POSIX
+static ulog_crash_region_t  ulog_crash_fallback;    /* ļӳʧʱʹã̱ */
+#else
+static ulog_crash_region_t  ulog_crash_mem __attribute__((section(LOG_CRASH_SECTION)));
+#endif
+static ulog_crash_region_t *ulog_crash;
+static size_t               ulog_crash_prev;        /* ϴ쳣ֹµֽ */
+static volatile bool        ulog_crash_replaying;
+
+static uint32_t crash_crc32(const void *buf, size_t len)
+{
+    const uint8_t *p = buf;
+    uint32_t crc = 0xFFFFFFFFu;
+
+    while (len--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+static bool crash_valid(const ulog_crash_region_t *r)
+{
+    return r->magic == CRASH_MAGIC && r->size == LOG_CRASH_SIZE &&
+           r->crc == crash_crc32(r, offsetof(ulog_crash_region_t, crc));
+}
+
+static void crash_seal(ulog_crash_region_t *r)
+{
+    r->crc = crash_crc32(r, offsetof(ulog_crash_region_t, crc));
+}
+
+static void crash_copy(uint32_t pos, const char *src, size_t n)
+{
+    size_t off   = pos & CRASH_MASK;
+    size_t first = (n < LOG_CRASH_SIZE - off) ? n : LOG_CRASH_SIZE - off;
+
+    memcpy(ulog_crash->data + off, src, first);
+    memcpy(ulog_crash->data, src + first, n - first);
+}
+
+/* һ¼㣻ѻʱһ */
+static uint32_t crash_oldest(uint32_t head)
+{
+    uint32_t start = ulog_crash->full ? head - LOG_CRASH_SIZE : 0;
+
+    if (ulog_crash->full) {
+        while (start != head && ulog_crash->data[start++ & CRASH_MASK] != '\n') {
+        }
+    }
+    return start;
+}
+
+/* лطŵˣʱύδͬ */
+static void crash_replay(uint32_t head)
+{
+    uint32_t pos = crash_oldest(head);
+
+    ulog_crash_replaying = true;
+    ulog_output_ex(ULOG_RTT_TERMINAL_ID, 0, "", "---- crash log: %lu bytes, boot %lu ----\r\n",
+                   (unsigned long)(head - pos), (unsigned long)ulog_crash->boots);
+    while (pos != head) {
+        size_t off = pos & CRASH_MASK;
+        size_t n = 0;
+        /* һβĩβ 128 ֽΪֹ */
+        while (pos + n != head && off + n < LOG_CRASH_SIZE && n < 128) {
+            if (ulog_crash->data[off + n++] == '\n') {
+                break;
+            }
+        }
+        ulog_output_ex(ULOG_RTT_TERMINAL_ID, 0, "", "%.*s", (int)n, ulog_crash->data + off);
+        pos += (uint32_t)n;
+    }
+    ulog_output_ex(ULOG_RTT_TERMINAL_ID, 0, "", "\r\n---- end of crash log ----\r\n");
+    ulog_crash_replaying = false;
+}
+
+void ulog_crash_init(void)
+{
+#if ULOG_PORT_POSIX
+    int fd = open(LOG_CRASH_FILE, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    void *p = MAP_FAILED;
+    if (fd >= 0 && ftruncate(fd, sizeof(ulog_crash_region_t)) == 0) {
+        p = mmap(NULL, sizeof(ulog_crash_region_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    ulog_crash = (p != MAP_FAILED) ? (ulog_crash_region_t *)p : &ulog_crash_fallback;
+#else
+    ulog_crash = &ulog_crash_mem;
+#endif
+
+    ulog_crash_prev = 0;
+    if (!crash_valid(ulog_crash)) {
+        memset(ulog_crash, 0, offsetof(ulog_crash_region_t, data));
+        ulog_crash->magic = CRASH_MAGIC;
+        ulog_crash->size  = LOG_CRASH_SIZE;
+    } else if (ulog_crash->state != CRASH_CLEAN && atomic_load(&ulog_crash->head) != 0) {
+        uint32_t head = atomic_load(&ulog_crash->head);
+        ulog_crash_prev = head - crash_oldest(head);
+#if LOG_CRASH_REPLAY
+        crash_replay(head);
+#endif
+    }
+    ulog_crash->boots++;
+    crash_seal(ulog_crash);
+    ulog_crash->state = CRASH_RUNNING;
+}
+
+void ulog_crash_record(const char *msg, size_t len)
+{
+    uint32_t head;
+
+    if (ulog_crash == NULL || ulog_crash_replaying) {
+        return;
+    }
+    if (len > LOG_CRASH_SIZE) {
+        msg += len - LOG_CRASH_SIZE;
+        len  = LOG_CRASH_SIZE;
+    }
+#if CRASH_CONCURRENT
+    /* ռλٿд߸Եõص */
+    head = atomic_fetch_add_explicit(&ulog_crash->head, (unsigned)len, memory_order_relaxed);
+    crash_copy(head, msg, len);
+    if (!ulog_crash->full && head + len >= LOG_CRASH_SIZE) {
+        ulog_crash->full = 1;
+    }
+#else
+    head = atomic_load_explicit(&ulog_crash->head, memory_order_relaxed);
+    crash_copy(head, msg, len);
+    /*  head ڴ棬дһ븴λʱ¼ */
+    atomic_signal_fence(memory_order_release);
+    atomic_store_explicit(&ulog_crash->head, head + (uint32_t)len, memory_order_relaxed);
+    if (!ulog_crash->full && head + len >= LOG_CRASH_SIZE) {
+        ulog_crash->full = 1;
+    }
+#endif
+}
+
+void ulog_crash_deinit(void)
+{
+    if (ulog_crash == NULL) {
+        return;
+    }
+    ulog_crash->state = CRASH_CLEAN;
+#if ULOG_PORT_POSIX
+    if (ulog_crash != &ulog_crash_fallback) {
+        munmap(ulog_crash, sizeof(ulog_crash_region_t));
+    }
+#endif
+    ulog_crash = NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/* ȡӿ                                                                   */
+/* -------------------------------------------------------------------------- */
+size_t ulog_crash_found(void)
+{
+    return ulog_crash_prev;
+}
+
+size_t ulog_crash_read(char *buf, size_t size)
+{
+    size_t len = 0;
+
+    if (buf == NULL || size == 0) {
+        return 0;
+    }
+    if (ulog_crash != NULL) {
+        uint32_t head = atomic_load(&ulog_crash->head);
+        uint32_t pos  = crash_oldest(head);
+        /* ŲʱµĲ֣һпʼ */
+        if (head - pos > size - 1) {
+            pos = head - (uint32_t)(size - 1);
+            while (pos != head && ulog_crash->data[pos++ & CRASH_MASK] != '\n') {
+            }
+        }
+        while (pos != head) {
+            buf[len++] = ulog_crash->data[pos++ & CRASH_MASK];
+        }
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+void ulog_crash_clear(void)
+{
+    if (ulog_crash != NULL) {
+        atomic_store(&ulog_crash->head, 0);
+        ulog_crash->full = 0;
+    }
+    ulog_crash_prev = 0;
+}
+
+#endif /* LOG_ENABLE_CRASH_LOG */
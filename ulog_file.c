@@ -0,0 +1,289 @@
+#include "ulog.h"
+
+#if LOG_ENABLE_FILE
+
+#if !ULOG_PORT_POSIX
+#error "LOG_ENABLE_FILE requires a POSIX target (ULOG_PORT_POSIX)"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+/* -------------------------------------------------------------------------- */
+/* ļˣû̬ + Сת                                          */
+/* -------------------------------------------------------------------------- */
+/* ־׷ӵ LOG_FILE_BUFFER_SIZE Ļ write һΣ
+ *   - Ų¼¼¼뻺һ writev
+ *   - յ ERROR/ASSERT
+ *   - ͣ LOG_FILE_FLUSH_MSɺ̨̼߳飩
+ *   - ulog_flush() / ulog_deinit()
+ * ǰļд LOG_FILE_MAX_SIZE ʱθΪ .1 .2 ...ౣ
+ * LOG_FILE_MAX_COUNT ļǰļ */
+#if (LOG_FILE_MAX_COUNT < 1)
+#error "LOG_FILE_MAX_COUNT must be at least 1"
+#endif
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    pthread_t       thread;
+    bool            running;
+    int             fd;
+    size_t          file_size;      /* ǰļдֽ */
+    size_t          len;            /* ддֽ */
+    uint64_t        dirty_ms;       /* һݵʱ */
+    uint64_t        synced_ms;      /* ϴ fdatasync ʱ */
+    bool            unsynced;       /*  write δ fdatasync  */
+    char            buf[LOG_FILE_BUFFER_SIZE];
+} ulog_file = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .fd   = -1,
+};
+
+static uint64_t file_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static void file_open(void)
+{
+    struct stat st;
+
+    ulog_file.fd = open(LOG_FILE_PATH, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    ulog_file.file_size = (ulog_file.fd >= 0 && fstat(ulog_file.fd, &st) == 0) ? (size_t)st.st_size : 0;
+}
+
+/* path -> path.1 -> ... -> path.(N-1)ɵı */
+static void file_rotate(void)
+{
+    char from[sizeof(LOG_FILE_PATH) + 8];
+    char to[sizeof(LOG_FILE_PATH) + 8];
+
+    if (ulog_file.fd >= 0) {
+        close(ulog_file.fd);
+        ulog_file.fd = -1;
+    }
+    if (LOG_FILE_MAX_COUNT > 1) {
+        for (int i = LOG_FILE_MAX_COUNT - 2; i > 0; i--) {
+            snprintf(from, sizeof(from), "%s.%d", LOG_FILE_PATH, i);
+            snprintf(to, sizeof(to), "%s.%d", LOG_FILE_PATH, i + 1);
+            rename(from, to);
+        }
+        snprintf(to, sizeof(to), "%s.1", LOG_FILE_PATH);
+        rename(LOG_FILE_PATH, to);
+    } else {
+        unlink(LOG_FILE_PATH);
+    }
+    file_open();
+}
+
+/* д iov ȫݣд EINTR */
+static void file_writev(struct iovec *iov, int cnt)
+{
+    while (cnt > 0 && ulog_file.fd >= 0) {
+        ssize_t n = writev(ulog_file.fd, iov, cnt);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;                  /* ȴ󣺶 */
+        }
+        ulog_file.file_size += (size_t)n;
+        ulog_file.unsynced = true;
+        while (cnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            cnt--;
+        }
+        if (cnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+}
+
+/* ߳extra Ϊ滺һдĳ¼ */
+static void file_flush_locked(const ulog_seg_t *extra)
+{
+    struct iovec iov[1 + ULOG_SEG_COUNT];
+    int cnt = 0;
+
+    if (ulog_file.len) {
+        iov[cnt].iov_base = ulog_file.buf;
+        iov[cnt].iov_len  = ulog_file.len;
+        cnt++;
+    }
+    for (int i = 0; extra != NULL && i < ULOG_SEG_COUNT; i++) {
+        if (extra[i].len) {
+            iov[cnt].iov_base = (void *)extra[i].ptr;
+            iov[cnt].iov_len  = extra[i].len;
+            cnt++;
+        }
+    }
+    /* ļδ򿪣ulog_init ֮ǰʱݣֻŲµĳ¼ */
+    if (ulog_file.fd < 0) {
+        return;
+    }
+    file_writev(iov, cnt);
+    ulog_file.len = 0;
+}
+
+static void file_sync_locked(void)
+{
+    if (ulog_file.unsynced && ulog_file.fd >= 0) {
+        fdatasync(ulog_file.fd);
+    }
+    ulog_file.unsynced  = false;
+    ulog_file.synced_ms = file_now_ms();
+}
+
+static void backend_file_write(ulog_backend_t *be, unsigned char terminal, char level,
+                               const char *tag, const ulog_seg_t seg[ULOG_SEG_COUNT])
+{
+    size_t n = 0;
+
+    (void)be;
+    (void)terminal;
+    (void)tag;
+    for (int i = 0; i < ULOG_SEG_COUNT; i++) {
+        n += seg[i].len;
+    }
+
+    pthread_mutex_lock(&ulog_file.lock);
+
+    if (ulog_file.file_size + ulog_file.len + n > LOG_FILE_MAX_SIZE &&
+        ulog_file.file_size + ulog_file.len > 0) {
+        file_flush_locked(NULL);
+        if (ulog_file.fd >= 0) {
+            file_rotate();
+        }
+    }
+
+    if (n > sizeof(ulog_file.buf) - ulog_file.len) {
+        if (n > sizeof(ulog_file.buf) / 2) {
+            /* ¼ٿ뻺ݺϳһ writev */
+            file_flush_locked(seg);
+            n = 0;
+        } else {
+            file_flush_locked(NULL);
+            if (ulog_file.len) {
+                n = 0;              /* ļδһ */
+            }
+        }
+    }
+    if (n) {
+        if (ulog_file.len == 0) {
+            ulog_file.dirty_ms = file_now_ms();
+        }
+        for (int i = 0; i < ULOG_SEG_COUNT; i++) {
+            memcpy(ulog_file.buf + ulog_file.len, seg[i].ptr, seg[i].len);
+            ulog_file.len += seg[i].len;
+        }
+    }
+
+    /* ־ڻ̱ͣʱҲļ */
+    if (level == 'E' || level == 'A') {
+        file_flush_locked(NULL);
+#if (LOG_FILE_SYNC == ULOG_FILE_SYNC_ERROR)
+        file_sync_locked();
+#endif
+    }
+
+    pthread_mutex_unlock(&ulog_file.lock);
+}
+
+static void backend_file_flush(ulog_backend_t *be)
+{
+    (void)be;
+    pthread_mutex_lock(&ulog_file.lock);
+    file_flush_locked(NULL);
+#if (LOG_FILE_SYNC != ULOG_FILE_SYNC_NEVER)
+    file_sync_locked();
+#endif
+    pthread_mutex_unlock(&ulog_file.lock);
+}
+
+/* ̨̣߳дͣõĻݣԶ fdatasync */
+static void *file_task(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&ulog_file.lock);
+    while (ulog_file.running) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += (long)(LOG_FILE_FLUSH_MS % 1000) * 1000000L;
+        ts.tv_sec  += LOG_FILE_FLUSH_MS / 1000 + ts.tv_nsec / 1000000000L;
+        ts.tv_nsec %= 1000000000L;
+        pthread_cond_timedwait(&ulog_file.cond, &ulog_file.lock, &ts);
+
+        uint64_t now = file_now_ms();
+        if (ulog_file.len && now - ulog_file.dirty_ms >= LOG_FILE_FLUSH_MS) {
+            file_flush_locked(NULL);
+        }
+#if (LOG_FILE_SYNC == ULOG_FILE_SYNC_PERIODIC)
+        if (now - ulog_file.synced_ms >= LOG_FILE_SYNC_MS) {
+            file_sync_locked();
+        }
+#endif
+    }
+    pthread_mutex_unlock(&ulog_file.lock);
+    return NULL;
+}
+
+static void backend_file_init(ulog_backend_t *be)
+{
+    (void)be;
+    pthread_mutex_lock(&ulog_file.lock);
+    if (ulog_file.fd < 0) {
+        file_open();
+    }
+    ulog_file.synced_ms = file_now_ms();
+    ulog_file.running   = true;
+    if (pthread_create(&ulog_file.thread, NULL, file_task, NULL) != 0) {
+        ulog_file.running = false;
+    }
+    pthread_mutex_unlock(&ulog_file.lock);
+}
+
+static void backend_file_deinit(ulog_backend_t *be)
+{
+    bool joined;
+
+    (void)be;
+    pthread_mutex_lock(&ulog_file.lock);
+    joined = ulog_file.running;
+    ulog_file.running = false;
+    pthread_cond_signal(&ulog_file.cond);
+    pthread_mutex_unlock(&ulog_file.lock);
+    if (joined) {
+        pthread_join(ulog_file.thread, NULL);
+    }
+
+    pthread_mutex_lock(&ulog_file.lock);
+    file_flush_locked(NULL);
+    file_sync_locked();
+    if (ulog_file.fd >= 0) {
+        close(ulog_file.fd);
+        ulog_file.fd = -1;
+    }
+    pthread_mutex_unlock(&ulog_file.lock);
+}
+
+ulog_backend_t ulog_backend_file = {
+    .name   = "file",
+    .level  = ULOG_LEVEL_VERBOSE,
+    .init   = backend_file_init,
+    .write  = backend_file_write,
+    .flush  = backend_file_flush,
+    .deinit = backend_file_deinit,
+};
+
+#endif /* LOG_ENABLE_FILE */
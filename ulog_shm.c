@@ -0,0 +1,179 @@
+#include "ulog.h"
+
+#if LOG_ENABLE_SHM
+
+#if !ULOG_PORT_POSIX
+#error "LOG_ENABLE_SHM requires a POSIX target (ULOG_PORT_POSIX)"
+#endif
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/* -------------------------------------------------------------------------- */
+/* ڴˣдߡߵĻλ                                   */
+/* -------------------------------------------------------------------------- */
+/*  RTT лͬģͣдֻǰдӲȴߣ߸Աλã
+ * 󳬹һȦʱ tailɵ¼¿ʼʧŵó
+ * дһ¼˳
+ *   1. Խǵľɼ¼ƽ tail
+ *   2.  reserve = µĩβ
+ *   3. ¼Կĩβ
+ *   4.  head = reserve
+ * ֻڴ濽ԭдûϵͳãֻڶ߳ͬʱʱŻ
+ * ںˡڴ ulog_init() ʱգ˳鿴ܶȡ */
+#if (LOG_SHM_SIZE & (LOG_SHM_SIZE - 1)) || (LOG_SHM_SIZE < 4096)
+#error "LOG_SHM_SIZE must be a power of two >= 4096"
+#endif
+
+#define SHM_MASK            ((uint64_t)LOG_SHM_SIZE - 1)
+#define SHM_ALIGN(n)        (((n) + 7u) & ~(size_t)7u)
+#define SHM_RECORD_MAX      (LOG_SHM_SIZE / 4)
+#define SHM_AT(field)       ((_Atomic uint64_t *)&ulog_shm.hdr->field)
+
+static struct {
+    pthread_mutex_t    lock;
+    ulog_shm_header_t *hdr;
+    char              *data;
+} ulog_shm = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static void shm_copy_in(uint64_t pos, const void *src, size_t n)
+{
+    size_t off   = (size_t)(pos & SHM_MASK);
+    size_t first = (n < LOG_SHM_SIZE - off) ? n : LOG_SHM_SIZE - off;
+
+    memcpy(ulog_shm.data + off, src, first);
+    memcpy(ulog_shm.data, (const char *)src + first, n - first);
+}
+
+static void shm_copy_out(uint64_t pos, void *dst, size_t n)
+{
+    size_t off   = (size_t)(pos & SHM_MASK);
+    size_t first = (n < LOG_SHM_SIZE - off) ? n : LOG_SHM_SIZE - off;
+
+    memcpy(dst, ulog_shm.data + off, first);
+    memcpy((char *)dst + first, ulog_shm.data, n - first);
+}
+
+static void backend_shm_write(ulog_backend_t *be, unsigned char terminal, char level,
+                              const char *tag, const ulog_seg_t seg[ULOG_SEG_COUNT])
+{
+    ulog_shm_record_t rec;
+    size_t tag_len = (tag != NULL) ? strlen(tag) : 0;
+    size_t pre_len = seg[ULOG_SEG_PREFIX].len;
+    size_t body_len = seg[ULOG_SEG_BODY].len;
+
+    (void)be;
+    if (ulog_shm.hdr == NULL) {
+        return;
+    }
+    if (tag_len > 0xFF) {
+        tag_len = 0xFF;
+    }
+    /* ¼ضϣ֤һȦɶ¼ */
+    size_t room = SHM_RECORD_MAX - sizeof(rec) - tag_len;
+    if (pre_len > room) {
+        pre_len = room;
+    }
+    if (body_len > room - pre_len) {
+        body_len = room - pre_len;
+    }
+    rec.size     = (uint32_t)(sizeof(rec) + tag_len + pre_len + body_len);
+    rec.level    = level;
+    rec.terminal = terminal;
+    rec.tag_len  = (uint8_t)tag_len;
+    rec.reserved = 0;
+
+    pthread_mutex_lock(&ulog_shm.lock);
+
+    uint64_t head = atomic_load_explicit(SHM_AT(head), memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(SHM_AT(tail), memory_order_relaxed);
+    uint64_t end  = head + SHM_ALIGN(rec.size);
+    uint64_t seq  = atomic_load_explicit(SHM_AT(seq), memory_order_relaxed);
+
+    /* Խǵļ¼Щ¼ͷֻɱд룬ȡǰȫ */
+    while (end - tail > LOG_SHM_SIZE) {
+        uint32_t old;
+        shm_copy_out(tail, &old, sizeof(old));
+        tail += SHM_ALIGN(old);
+    }
+    atomic_store_explicit(SHM_AT(tail), tail, memory_order_relaxed);
+    atomic_store_explicit(SHM_AT(reserve), end, memory_order_relaxed);
+    /* reserve ڸǾݿɼ߿ reserve ɷֱ */
+    atomic_thread_fence(memory_order_release);
+
+    rec.seq = (uint32_t)seq;
+    shm_copy_in(head, &rec, sizeof(rec));
+    head += sizeof(rec);
+    shm_copy_in(head, tag, tag_len);
+    head += tag_len;
+    shm_copy_in(head, seg[ULOG_SEG_PREFIX].ptr, pre_len);
+    head += pre_len;
+    shm_copy_in(head, seg[ULOG_SEG_BODY].ptr, body_len);
+
+    atomic_store_explicit(SHM_AT(seq), seq + 1, memory_order_relaxed);
+    atomic_store_explicit(SHM_AT(head), end, memory_order_release);
+
+    pthread_mutex_unlock(&ulog_shm.lock);
+}
+
+static void backend_shm_init(ulog_backend_t *be)
+{
+    size_t total = sizeof(ulog_shm_header_t) + LOG_SHM_SIZE;
+    void *p = MAP_FAILED;
+
+    (void)be;
+    int fd = shm_open(LOG_SHM_NAME, O_RDWR | O_CREAT, 0644);
+    if (fd >= 0 && ftruncate(fd, (off_t)total) == 0) {
+        p = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (p == MAP_FAILED) {
+        return;
+    }
+
+    pthread_mutex_lock(&ulog_shm.lock);
+    ulog_shm.hdr  = (ulog_shm_header_t *)p;
+    ulog_shm.data = (char *)p + sizeof(ulog_shm_header_t);
+
+    /*  magic λãѸӵĶ߿ pid 仯ͷʼ */
+    atomic_store_explicit((_Atomic uint32_t *)&ulog_shm.hdr->magic, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    ulog_shm.hdr->version = ULOG_SHM_VERSION;
+    ulog_shm.hdr->size    = LOG_SHM_SIZE;
+    ulog_shm.hdr->pid     = (uint32_t)getpid();
+    atomic_store_explicit(SHM_AT(head), 0, memory_order_relaxed);
+    atomic_store_explicit(SHM_AT(reserve), 0, memory_order_relaxed);
+    atomic_store_explicit(SHM_AT(tail), 0, memory_order_relaxed);
+    atomic_store_explicit(SHM_AT(seq), 0, memory_order_relaxed);
+    atomic_store_explicit((_Atomic uint32_t *)&ulog_shm.hdr->magic, ULOG_SHM_MAGIC, memory_order_release);
+    pthread_mutex_unlock(&ulog_shm.lock);
+}
+
+static void backend_shm_deinit(ulog_backend_t *be)
+{
+    (void)be;
+    pthread_mutex_lock(&ulog_shm.lock);
+    if (ulog_shm.hdr != NULL) {
+        munmap(ulog_shm.hdr, sizeof(ulog_shm_header_t) + LOG_SHM_SIZE);
+        ulog_shm.hdr  = NULL;
+        ulog_shm.data = NULL;
+    }
+    pthread_mutex_unlock(&ulog_shm.lock);
+}
+
+ulog_backend_t ulog_backend_shm = {
+    .name   = "shm",
+    .level  = ULOG_LEVEL_VERBOSE,
+    .init   = backend_shm_init,
+    .write  = backend_shm_write,
+    .deinit = backend_shm_deinit,
+};
+
+#endif /* LOG_ENABLE_SHM */
@@ -0,0 +1,361 @@
+#include "ulog.h"
+
+#if LOG_ENABLE_STORE
+
+#if !ULOG_PORT_POSIX
+#error "LOG_ENABLE_STORE requires a POSIX target (ULOG_PORT_POSIX)"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+/* -------------------------------------------------------------------------- */
+/* ־洢 + ͷϡ                                    */
+/* -------------------------------------------------------------------------- */
+/* ļ = 64 ֽļͷ + LOG_STORE_MAX_BLOCKS  LOG_STORE_BLOCK_SIZE ֽڵĿ飬
+ *  seq дڲ seq % LOG_STORE_MAX_BLOCKSд󸲸ɵĿ顣
+ * ͷ¼ÿʱ䷶Χͱǩϣ64 λλͼȡֻͷ
+ * صĿ顣ڼ¼
+ *   code   u8        A E W I D V = 0..5RAW = 6
+ *   tag    varint   ڱǩţڵǰǩʱ u8  + ֣±ǩ
+ *   dt     varint   һ¼ʱ (us)һԿͷ first_us
+ *   len    varint   ĳȣΪģ [E/TAG] ǰ׺ʱβУ
+ * ÿԴǩԵ롣ʱȡ CLOCK_REALTIME¹ʱա
+ * ǰԭдļpwrite ͬһλãдյ ERROR/ASSERT
+ * ͣ LOG_STORE_FLUSH_MSulog_flush() / ulog_deinit() */
+#define STORE_FILE_MAGIC    "ULOGSTR1"
+#define STORE_FILE_HDR      64u
+#define STORE_BLOCK_MAGIC   0x4B42534Cu     /* "LSBK" */
+#define STORE_CODE_RAW      6u
+#define STORE_TAG_MAX       255u
+#define STORE_REC_MAX       (LOG_STORE_BLOCK_SIZE - sizeof(ulog_store_block_t))
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint64_t first_us;
+    uint64_t last_us;
+    uint64_t tag_bloom;         /* bit (fnv1a(tag) & 63) */
+    uint32_t used;              /* ͷ֮ļ¼ֽ */
+    uint16_t nrec;
+    uint8_t  level_mask;        /* bit code */
+    uint8_t  ntags;
+    uint8_t  reserved[8];
+} ulog_store_block_t;
+
+_Static_assert(sizeof(ulog_store_block_t) == 48, "block header layout");
+_Static_assert(LOG_STORE_BLOCK_SIZE >= 1024, "LOG_STORE_BLOCK_SIZE too small");
+
+static struct {
+    pthread_mutex_t     lock;
+    pthread_cond_t      cond;
+    pthread_t           thread;
+    bool                running;
+    int                 fd;
+    uint32_t            seq;            /* ǰ */
+    uint64_t            prev_us;        /* һ¼ʱ */
+    uint64_t            dirty_ms;       /* ǰδдݵʱ䣬0 = д */
+    char                tag_name[STORE_TAG_MAX][24];    /* ڱǩ */
+    union {
+        ulog_store_block_t hdr;
+        uint8_t            raw[LOG_STORE_BLOCK_SIZE];
+    } blk;
+} ulog_store = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .fd   = -1,
+};
+
+static uint64_t store_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static uint64_t store_mono_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+static uint32_t store_tag_hash(const char *s, size_t n)
+{
+    uint32_t h = 2166136261u;
+    while (n--) {
+        h = (h ^ (uint8_t)*s++) * 16777619u;
+    }
+    return h;
+}
+
+static uint8_t *store_put_varint(uint8_t *p, uint64_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static void store_block_reset(uint64_t now_us)
+{
+    memset(&ulog_store.blk.hdr, 0, sizeof(ulog_store.blk.hdr));
+    ulog_store.blk.hdr.magic    = STORE_BLOCK_MAGIC;
+    ulog_store.blk.hdr.seq      = ulog_store.seq;
+    ulog_store.blk.hdr.first_us = now_us;
+    ulog_store.blk.hdr.last_us  = now_us;
+    ulog_store.prev_us          = now_us;
+}
+
+/* ǰ飨δĲ֣дĲλ */
+static void store_write_block_locked(void)
+{
+    off_t off = (off_t)STORE_FILE_HDR +
+                (off_t)(ulog_store.seq % LOG_STORE_MAX_BLOCKS) * LOG_STORE_BLOCK_SIZE;
+    size_t len = sizeof(ulog_store_block_t) + ulog_store.blk.hdr.used;
+    size_t done = 0;
+
+    while (ulog_store.fd >= 0 && done < len) {
+        ssize_t n = pwrite(ulog_store.fd, ulog_store.blk.raw + done, len - done, off + (off_t)done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;                  /* ȴ󣺱дʧܣ´ */
+        }
+        done += (size_t)n;
+    }
+    ulog_store.dirty_ms = 0;
+}
+
+static void store_next_block_locked(uint64_t now_us)
+{
+    store_write_block_locked();
+    ulog_store.seq++;
+    store_block_reset(now_us);
+}
+
+/* 򿪻½ļļĿСһʱд */
+static void store_open(void)
+{
+    uint8_t fh[STORE_FILE_HDR];
+    uint32_t next = 0;
+
+    ulog_store.fd = open(LOG_STORE_PATH, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (ulog_store.fd < 0) {
+        return;
+    }
+    if (pread(ulog_store.fd, fh, sizeof(fh), 0) == (ssize_t)sizeof(fh) &&
+        memcmp(fh, STORE_FILE_MAGIC, 8) == 0 &&
+        *(uint32_t *)(fh + 8) == LOG_STORE_BLOCK_SIZE &&
+        *(uint32_t *)(fh + 12) == LOG_STORE_MAX_BLOCKS) {
+        for (uint32_t i = 0; i < LOG_STORE_MAX_BLOCKS; i++) {
+            ulog_store_block_t h;
+            off_t off = (off_t)STORE_FILE_HDR + (off_t)i * LOG_STORE_BLOCK_SIZE;
+            if (pread(ulog_store.fd, &h, sizeof(h), off) != (ssize_t)sizeof(h)) {
+                break;
+            }
+            if (h.magic == STORE_BLOCK_MAGIC && h.seq + 1 > next) {
+                next = h.seq + 1;
+            }
+        }
+    } else {
+        memset(fh, 0, sizeof(fh));
+        memcpy(fh, STORE_FILE_MAGIC, 8);
+        *(uint32_t *)(fh + 8)  = LOG_STORE_BLOCK_SIZE;
+        *(uint32_t *)(fh + 12) = LOG_STORE_MAX_BLOCKS;
+        if (ftruncate(ulog_store.fd, 0) != 0 ||
+            pwrite(ulog_store.fd, fh, sizeof(fh), 0) != (ssize_t)sizeof(fh)) {
+            close(ulog_store.fd);
+            ulog_store.fd = -1;
+            return;
+        }
+    }
+    ulog_store.seq = next;
+    store_block_reset(store_now_us());
+}
+
+/* ڱǩţ±ǩ ntagsɵд */
+static unsigned store_tag_find(const char *tag, size_t len)
+{
+    unsigned n = ulog_store.blk.hdr.ntags;
+
+    /* ύģʽ±ǩͬһջַܰȽ */
+    for (unsigned i = 0; i < n; i++) {
+        if (ulog_store.tag_name[i][len] == '\0' && memcmp(ulog_store.tag_name[i], tag, len) == 0) {
+            return i;
+        }
+    }
+    return n;
+}
+
+static void backend_store_write(ulog_backend_t *be, unsigned char terminal, char level,
+                                const char *tag, const ulog_seg_t *seg)
+{
+    static const char codes[] = "AEWIDV";
+    const char *body = seg[ULOG_SEG_BODY].ptr;
+    size_t len = seg[ULOG_SEG_BODY].len;
+    const char *lv = level ? strchr(codes, level) : NULL;
+    unsigned code = (lv != NULL) ? (unsigned)(lv - codes) : STORE_CODE_RAW;
+    size_t tlen;
+    uint8_t rec[32 + sizeof(ulog_store.tag_name[0])];
+    uint8_t *p = rec;
+
+    (void)be;
+    (void)terminal;
+    if (tag == NULL) {
+        tag = "";
+    }
+    tlen = strlen(tag);
+    if (tlen >= sizeof(ulog_store.tag_name[0])) {
+        tlen = sizeof(ulog_store.tag_name[0]) - 1;
+    }
+    while (len && (body[len - 1] == '\n' || body[len - 1] == '\r')) {
+        len--;
+    }
+
+    pthread_mutex_lock(&ulog_store.lock);
+    if (ulog_store.fd < 0) {
+        pthread_mutex_unlock(&ulog_store.lock);
+        return;
+    }
+    uint64_t now = store_now_us();
+    unsigned id = store_tag_find(tag, tlen);
+
+    /* Ų£ǩʱ飻ĳʱض */
+    size_t need = 3 * 10 + 1 + ((id == ulog_store.blk.hdr.ntags) ? 1 + tlen : 0) + len;
+    if (id >= STORE_TAG_MAX || ulog_store.blk.hdr.used + need > STORE_REC_MAX) {
+        store_next_block_locked(now);
+        id = 0;
+        need = 3 * 10 + 2 + tlen + len;
+        if (need > STORE_REC_MAX) {
+            len -= need - STORE_REC_MAX;
+        }
+    }
+    ulog_store_block_t *h = &ulog_store.blk.hdr;
+    if (h->nrec == 0) {
+        h->first_us = now;              /* ʱ䷶Χӵһ¼ʼ */
+        ulog_store.prev_us = now;
+    } else if (now < ulog_store.prev_us) {
+        now = ulog_store.prev_us;       /* ʱ䲻 */
+    }
+
+    *p++ = (uint8_t)code;
+    p = store_put_varint(p, id);
+    if (id == h->ntags) {
+        *p++ = (uint8_t)tlen;
+        memcpy(p, tag, tlen);
+        p += tlen;
+        memcpy(ulog_store.tag_name[id], tag, tlen);
+        ulog_store.tag_name[id][tlen] = '\0';
+        h->tag_bloom |= 1ull << (store_tag_hash(tag, tlen) & 63u);
+        h->ntags++;
+    }
+    p = store_put_varint(p, now - ulog_store.prev_us);
+    p = store_put_varint(p, len);
+
+    uint8_t *dst = ulog_store.blk.raw + sizeof(*h) + h->used;
+    memcpy(dst, rec, (size_t)(p - rec));
+    memcpy(dst + (p - rec), body, len);
+    h->used += (uint32_t)((size_t)(p - rec) + len);
+    h->nrec++;
+    h->level_mask |= (uint8_t)(1u << code);
+    h->last_us = now;
+    ulog_store.prev_us = now;
+    if (ulog_store.dirty_ms == 0) {
+        ulog_store.dirty_ms = store_mono_ms();
+    }
+
+    /* ־䵽ļ */
+    if (level == 'E' || level == 'A') {
+        store_write_block_locked();
+    }
+    pthread_mutex_unlock(&ulog_store.lock);
+}
+
+static void backend_store_flush(ulog_backend_t *be)
+{
+    (void)be;
+    pthread_mutex_lock(&ulog_store.lock);
+    if (ulog_store.dirty_ms) {
+        store_write_block_locked();
+    }
+    pthread_mutex_unlock(&ulog_store.lock);
+}
+
+/* ̨̣߳дͣõĵǰ */
+static void *store_task(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&ulog_store.lock);
+    while (ulog_store.running) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += (long)(LOG_STORE_FLUSH_MS % 1000) * 1000000L;
+        ts.tv_sec  += LOG_STORE_FLUSH_MS / 1000 + ts.tv_nsec / 1000000000L;
+        ts.tv_nsec %= 1000000000L;
+        pthread_cond_timedwait(&ulog_store.cond, &ulog_store.lock, &ts);
+
+        if (ulog_store.dirty_ms && store_mono_ms() - ulog_store.dirty_ms >= LOG_STORE_FLUSH_MS) {
+            store_write_block_locked();
+        }
+    }
+    pthread_mutex_unlock(&ulog_store.lock);
+    return NULL;
+}
+
+static void backend_store_init(ulog_backend_t *be)
+{
+    (void)be;
+    pthread_mutex_lock(&ulog_store.lock);
+    if (ulog_store.fd < 0) {
+        store_open();
+    }
+    ulog_store.running = true;
+    if (pthread_create(&ulog_store.thread, NULL, store_task, NULL) != 0) {
+        ulog_store.running = false;
+    }
+    pthread_mutex_unlock(&ulog_store.lock);
+}
+
+static void backend_store_deinit(ulog_backend_t *be)
+{
+    bool joined;
+
+    (void)be;
+    pthread_mutex_lock(&ulog_store.lock);
+    joined = ulog_store.running;
+    ulog_store.running = false;
+    pthread_cond_signal(&ulog_store.cond);
+    pthread_mutex_unlock(&ulog_store.lock);
+    if (joined) {
+        pthread_join(ulog_store.thread, NULL);
+    }
+
+    pthread_mutex_lock(&ulog_store.lock);
+    if (ulog_store.dirty_ms) {
+        store_write_block_locked();
+    }
+    if (ulog_store.fd >= 0) {
+        fdatasync(ulog_store.fd);
+        close(ulog_store.fd);
+        ulog_store.fd = -1;
+    }
+    pthread_mutex_unlock(&ulog_store.lock);
+}
+
+ulog_backend_t ulog_backend_store = {
+    .name   = "store",
+    .level  = ULOG_LEVEL_VERBOSE,
+    .init   = backend_store_init,
+    .write  = backend_store_write,
+    .flush  = backend_store_flush,
+    .deinit = backend_store_deinit,
+};
+
+#endif /* LOG_ENABLE_STORE */
@@ -0,0 +1,323 @@
+#include "ulog.h"
+
+#if LOG_ENABLE_NETWORK
+
+#if !ULOG_PORT_POSIX
+#error "LOG_ENABLE_NETWORK requires a POSIX target (ULOG_PORT_POSIX)"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+/* -------------------------------------------------------------------------- */
+/* syslog ˣRFC 5424 ϢUDP                                        */
+/* -------------------------------------------------------------------------- */
+/* <PRI>1 TIMESTAMP HOSTNAME APP-NAME PROCID - - MSG
+ *   PRI      : LOG_NETWORK_FACILITY * 8 + ɼӳ severity
+ *   APP-NAME : ־ǩޱǩʱΪ "-"
+ *   MSG      : ģ [E/TAG] ǰ׺βУ
+ * LOG_NETWORK_BATCH Ϊ 1 ʱϢ '\n' ָװͬһģյ
+ * ERROR/ASSERT ͣ LOG_NETWORK_FLUSH_MS ʱͣΪ 0 ʱÿϢ
+ * һģRFC 5426׽ΪͻʱĲ
+ * ߡ */
+#define SYSLOG_HOST_MAX     64
+#define SYSLOG_APP_MAX      48
+
+static struct {
+    pthread_mutex_t         lock;
+    pthread_cond_t          cond;
+    pthread_t               thread;
+    bool                    running;
+    int                     fd;
+    struct sockaddr_storage addr;
+    socklen_t               addr_len;
+    char                    host[SYSLOG_HOST_MAX];
+    char                    procid[12];
+    time_t                  ts_sec;         /* ts Ӧ */
+    char                    ts[32];         /* "YYYY-MM-DDThh:mm:ss" */
+    size_t                  len;            /* еֽ */
+    uint64_t                dirty_ms;       /* һϢʱ */
+    uint32_t                dropped;
+    char                    dgram[LOG_NETWORK_MTU];
+} ulog_syslog = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .fd   = -1,
+};
+
+/* ַ -> syslog severityRAW  notice(5)  */
+static uint8_t syslog_severity(char level)
+{
+    switch (level) {
+        case 'A': return 2;     /* critical */
+        case 'E': return 3;     /* error */
+        case 'W': return 4;     /* warning */
+        case 'I': return 6;     /* informational */
+        case 'D':
+        case 'V': return 7;     /* debug */
+        default : return 5;     /* notice */
+    }
+}
+
+static uint64_t syslog_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+/* ߳EAGAIN ȴֻ */
+static void syslog_send_locked(void)
+{
+    if (ulog_syslog.len == 0) {
+        return;
+    }
+    if (ulog_syslog.fd >= 0 && ulog_syslog.addr_len != 0) {
+        if (sendto(ulog_syslog.fd, ulog_syslog.dgram, ulog_syslog.len, MSG_DONTWAIT,
+                   (const struct sockaddr *)&ulog_syslog.addr, ulog_syslog.addr_len) < 0) {
+            ulog_syslog.dropped++;
+        }
+    } else {
+        ulog_syslog.dropped++;
+    }
+    ulog_syslog.len = 0;
+}
+
+static size_t syslog_put(char *p, size_t room, const char *s, size_t n)
+{
+    if (n > room) {
+        n = room;
+    }
+    memcpy(p, s, n);
+    return n;
+}
+
+/* һ RFC 5424 Ϣͷس */
+static size_t syslog_header(char *p, size_t room, char level, const char *tag)
+{
+    struct timespec now;
+    char pri[8];
+    size_t n = 0;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+    if (now.tv_sec != ulog_syslog.ts_sec) {
+        struct tm tm;
+        gmtime_r(&now.tv_sec, &tm);
+        strftime(ulog_syslog.ts, sizeof(ulog_syslog.ts), "%Y-%m-%dT%H:%M:%S", &tm);
+        ulog_syslog.ts_sec = now.tv_sec;
+    }
+
+    snprintf(pri, sizeof(pri), "<%u>1 ", LOG_NETWORK_FACILITY * 8u + syslog_severity(level));
+    n += syslog_put(p + n, room - n, pri, strlen(pri));
+    n += syslog_put(p + n, room - n, ulog_syslog.ts, strlen(ulog_syslog.ts));
+
+    char frac[8] = { '.', 0, 0, 0, 'Z', ' ' };
+    unsigned ms = (unsigned)(now.tv_nsec / 1000000);
+    frac[1] = (char)('0' + ms / 100);
+    frac[2] = (char)('0' + ms / 10 % 10);
+    frac[3] = (char)('0' + ms % 10);
+    n += syslog_put(p + n, room - n, frac, 6);
+
+    n += syslog_put(p + n, room - n, ulog_syslog.host, strlen(ulog_syslog.host));
+    n += syslog_put(p + n, room - n, " ", 1);
+
+    /* APP-NAME ֻɴӡ ASCII Ҳո */
+    if (tag == NULL || *tag == '\0') {
+        n += syslog_put(p + n, room - n, "-", 1);
+    } else {
+        for (size_t i = 0; tag[i] && i < SYSLOG_APP_MAX && n < room; i++) {
+            char c = tag[i];
+            p[n++] = (c > ' ' && c < 0x7F) ? c : '_';
+        }
+    }
+    n += syslog_put(p + n, room - n, " ", 1);
+    n += syslog_put(p + n, room - n, ulog_syslog.procid, strlen(ulog_syslog.procid));
+    n += syslog_put(p + n, room - n, " - - ", 5);
+    return n;
+}
+
+static void backend_syslog_write(ulog_backend_t *be, unsigned char terminal, char level,
+                                 const char *tag, const ulog_seg_t seg[ULOG_SEG_COUNT])
+{
+    char msg[LOG_NETWORK_MTU];
+    const char *body = seg[ULOG_SEG_BODY].ptr;
+    size_t body_len = seg[ULOG_SEG_BODY].len;
+
+    (void)be;
+    (void)terminal;
+    while (body_len && (body[body_len - 1] == '\n' || body[body_len - 1] == '\r')) {
+        body_len--;
+    }
+    if (body_len == 0) {
+        return;                 /* УRAW ָеȣ */
+    }
+
+    pthread_mutex_lock(&ulog_syslog.lock);
+
+    size_t n = syslog_header(msg, sizeof(msg), level, tag);
+    size_t start = n;
+    n += syslog_put(msg + n, sizeof(msg) - n, body, body_len);
+    /* ԻзָϢе CR/LF ɿո */
+    for (size_t i = start; i < n; i++) {
+        if (msg[i] == '\r' || msg[i] == '\n') {
+            msg[i] = ' ';
+        }
+    }
+
+#if LOG_NETWORK_BATCH
+    /* ŲʱȷеıģϢضϵһ */
+    if (ulog_syslog.len && ulog_syslog.len + 1 + n > sizeof(ulog_syslog.dgram)) {
+        syslog_send_locked();
+    }
+    if (ulog_syslog.len) {
+        ulog_syslog.dgram[ulog_syslog.len++] = '\n';
+    } else {
+        ulog_syslog.dirty_ms = syslog_now_ms();
+    }
+    memcpy(ulog_syslog.dgram + ulog_syslog.len, msg, n);
+    ulog_syslog.len += n;
+    if (level == 'E' || level == 'A' ||
+        ulog_syslog.len + 1 >= sizeof(ulog_syslog.dgram)) {
+        syslog_send_locked();
+    }
+#else
+    memcpy(ulog_syslog.dgram, msg, n);
+    ulog_syslog.len = n;
+    syslog_send_locked();
+#endif
+
+    pthread_mutex_unlock(&ulog_syslog.lock);
+}
+
+static void backend_syslog_flush(ulog_backend_t *be)
+{
+    (void)be;
+    pthread_mutex_lock(&ulog_syslog.lock);
+    syslog_send_locked();
+    pthread_mutex_unlock(&ulog_syslog.lock);
+}
+
+/* ̨̣߳ͣ LOG_NETWORK_FLUSH_MS δ */
+static void *syslog_task(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&ulog_syslog.lock);
+    while (ulog_syslog.running) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += (long)(LOG_NETWORK_FLUSH_MS % 1000) * 1000000L;
+        ts.tv_sec  += LOG_NETWORK_FLUSH_MS / 1000 + ts.tv_nsec / 1000000000L;
+        ts.tv_nsec %= 1000000000L;
+        pthread_cond_timedwait(&ulog_syslog.cond, &ulog_syslog.lock, &ts);
+
+        if (ulog_syslog.len && syslog_now_ms() - ulog_syslog.dirty_ms >= LOG_NETWORK_FLUSH_MS) {
+            syslog_send_locked();
+        }
+    }
+    pthread_mutex_unlock(&ulog_syslog.lock);
+    return NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/* ÷ַеãַ                         */
+/* -------------------------------------------------------------------------- */
+bool ulog_syslog_set_server(const char *host, uint16_t port)
+{
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM };
+    struct addrinfo *res = NULL;
+    char service[8];
+    int fd;
+
+    snprintf(service, sizeof(service), "%u", (unsigned)port);
+    if (host == NULL || getaddrinfo(host, service, &hints, &res) != 0 || res == NULL) {
+        return false;
+    }
+    fd = socket(res->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        freeaddrinfo(res);
+        return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    pthread_mutex_lock(&ulog_syslog.lock);
+    syslog_send_locked();
+    if (ulog_syslog.fd >= 0) {
+        close(ulog_syslog.fd);
+    }
+    ulog_syslog.fd = fd;
+    memcpy(&ulog_syslog.addr, res->ai_addr, res->ai_addrlen);
+    ulog_syslog.addr_len = (socklen_t)res->ai_addrlen;
+    pthread_mutex_unlock(&ulog_syslog.lock);
+
+    freeaddrinfo(res);
+    return true;
+}
+
+uint32_t ulog_syslog_get_dropped(void)
+{
+    pthread_mutex_lock(&ulog_syslog.lock);
+    uint32_t n = ulog_syslog.dropped;
+    pthread_mutex_unlock(&ulog_syslog.lock);
+    return n;
+}
+
+static void backend_syslog_init(ulog_backend_t *be)
+{
+    (void)be;
+    if (gethostname(ulog_syslog.host, sizeof(ulog_syslog.host)) != 0 || ulog_syslog.host[0] == '\0') {
+        strcpy(ulog_syslog.host, "-");
+    }
+    ulog_syslog.host[sizeof(ulog_syslog.host) - 1] = '\0';
+    snprintf(ulog_syslog.procid, sizeof(ulog_syslog.procid), "%ld", (long)getpid());
+
+    if (ulog_syslog.fd < 0) {
+        ulog_syslog_set_server(LOG_NETWORK_HOST, LOG_NETWORK_PORT);
+    }
+
+    pthread_mutex_lock(&ulog_syslog.lock);
+    ulog_syslog.running = true;
+    if (pthread_create(&ulog_syslog.thread, NULL, syslog_task, NULL) != 0) {
+        ulog_syslog.running = false;
+    }
+    pthread_mutex_unlock(&ulog_syslog.lock);
+}
+
+static void backend_syslog_deinit(ulog_backend_t *be)
+{
+    bool joined;
+
+    (void)be;
+    pthread_mutex_lock(&ulog_syslog.lock);
+    joined = ulog_syslog.running;
+    ulog_syslog.running = false;
+    pthread_cond_signal(&ulog_syslog.cond);
+    pthread_mutex_unlock(&ulog_syslog.lock);
+    if (joined) {
+        pthread_join(ulog_syslog.thread, NULL);
+    }
+
+    pthread_mutex_lock(&ulog_syslog.lock);
+    syslog_send_locked();
+    if (ulog_syslog.fd >= 0) {
+        close(ulog_syslog.fd);
+        ulog_syslog.fd = -1;
+    }
+    ulog_syslog.addr_len = 0;
+    pthread_mutex_unlock(&ulog_syslog.lock);
+}
+
+ulog_backend_t ulog_backend_syslog = {
+    .name   = "syslog",
+    .level  = ULOG_LEVEL_VERBOSE,
+    .init   = backend_syslog_init,
+    .write  = backend_syslog_write,
+    .flush  = backend_syslog_flush,
+    .deinit = backend_syslog_deinit,
+};
+
+#endif /* LOG_ENABLE_NETWORK */